@@ -0,0 +1,159 @@
+// Andrei Nikitin 2022
+
+
+#include "AIBudgetSubsystem.h"
+
+#include "AIController.h"
+#include "Enemy.h"
+#include "EnemyBehaviorTreeComponent.h"
+#include "ShooterDemo.h"
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Behavior Tree Time (ms)"), STAT_BehaviorTreeTime, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Behavior Tree Ticks"), STAT_BehaviorTreeTicks, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Starved Behavior Trees"), STAT_StarvedBehaviorTrees, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Max Frames Starved"), STAT_MaxFramesStarved, STATGROUP_ShooterDemo);
+
+UAIBudgetSubsystem::UAIBudgetSubsystem() :
+	ReservedTime(0.f),
+	SpentTime(0.f),
+	NumTicked(0),
+	NumStarved(0),
+	BudgetMicroseconds(1500.f),
+	InitialTickCostMicroseconds(20.f),
+	CostSmoothing(0.2f)
+{
+
+}
+
+void UAIBudgetSubsystem::Deinitialize() {
+	Components.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UAIBudgetSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAIBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UAIBudgetSubsystem::RegisterComponent(UEnemyBehaviorTreeComponent* Component) {
+	if (!Component) {
+		return;
+	}
+
+	Component->AverageTickCost = InitialTickCostMicroseconds * 1e-6f;
+	Component->FramesStarved = 0;
+	//first tick is never held back
+	Component->bReservedTick = true;
+	ReservedTime += Component->AverageTickCost;
+	Components.AddUnique(Component);
+}
+
+void UAIBudgetSubsystem::UnregisterComponent(UEnemyBehaviorTreeComponent* Component) {
+	Components.RemoveSwap(Component);
+}
+
+bool UAIBudgetSubsystem::CanTick(UEnemyBehaviorTreeComponent* Component) {
+	if (Component->bReservedTick) {
+		return true;
+	}
+
+	//what is left after the ticks so far and the reservations still waiting
+	const float Budget{BudgetMicroseconds * 1e-6f};
+	if (SpentTime + ReservedTime + Component->AverageTickCost <= Budget) {
+		return true;
+	}
+
+	Component->FramesStarved++;
+	NumStarved++;
+	return false;
+}
+
+void UAIBudgetSubsystem::ReportTick(UEnemyBehaviorTreeComponent* Component, double Seconds) {
+	if (Component->bReservedTick) {
+		ReservedTime = FMath::Max(0.f, ReservedTime - Component->AverageTickCost);
+		Component->bReservedTick = false;
+	}
+	SpentTime += Seconds;
+
+	Component->AverageTickCost = FMath::Lerp(Component->AverageTickCost, static_cast<float>(Seconds), CostSmoothing);
+	Component->FramesStarved = 0;
+	NumTicked++;
+}
+
+int32 UAIBudgetSubsystem::GetCombatPriority(const UEnemyBehaviorTreeComponent* Component) {
+	const AAIController* Controller = Component->GetAIOwner();
+	const AEnemy* Enemy = Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr;
+	if (!Enemy) {
+		return 0;
+	}
+	if (Enemy->IsInAttackRange()) {
+		return 2;
+	}
+	return Enemy->CanSenseTargets() ? 0 : 1;
+}
+
+void UAIBudgetSubsystem::Tick(float DeltaTime) {
+	SET_FLOAT_STAT(STAT_BehaviorTreeTime, SpentTime * 1000.f);
+	SET_DWORD_STAT(STAT_BehaviorTreeTicks, NumTicked);
+	SET_DWORD_STAT(STAT_StarvedBehaviorTrees, NumStarved);
+
+	SpentTime = 0.f;
+	ReservedTime = 0.f;
+	NumTicked = 0;
+	NumStarved = 0;
+
+	struct FCandidate {
+		UEnemyBehaviorTreeComponent* Component;
+		int32 Priority;
+	};
+	TArray<FCandidate> Candidates;
+	int32 MaxFramesStarved{0};
+
+	for (int32 i = Components.Num() - 1; i >= 0; i--) {
+		UEnemyBehaviorTreeComponent* Component = Components[i].Get();
+		if (!Component) {
+			Components.RemoveAtSwap(i);
+			continue;
+		}
+
+		//stopped trees never come back to claim a reservation
+		if (!Component->IsComponentTickEnabled()) {
+			Component->bReservedTick = false;
+			Component->FramesStarved = 0;
+			continue;
+		}
+
+		//reservations that weren't used (tick interval not due) carry over
+		if (Component->bReservedTick) {
+			ReservedTime += Component->AverageTickCost;
+			continue;
+		}
+
+		MaxFramesStarved = FMath::Max(MaxFramesStarved, Component->FramesStarved);
+		const int32 Priority{GetCombatPriority(Component)};
+		//starved enemies get their turn next frame, round robin style
+		if (Priority == 2 || Component->FramesStarved > 0) {
+			FCandidate Candidate;
+			Candidate.Component = Component;
+			Candidate.Priority = Priority;
+			Candidates.Add(Candidate);
+		}
+	}
+	SET_DWORD_STAT(STAT_MaxFramesStarved, MaxFramesStarved);
+
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) {
+		if (A.Priority != B.Priority) {
+			return A.Priority > B.Priority;
+		}
+		return A.Component->FramesStarved > B.Component->FramesStarved;
+	});
+
+	//reserve slots in order until the budget is used up, at least one per frame so nobody starves forever
+	const float Budget{BudgetMicroseconds * 1e-6f};
+	for (const FCandidate& Candidate : Candidates) {
+		if (ReservedTime > 0.f && ReservedTime + Candidate.Component->AverageTickCost > Budget) {
+			break;
+		}
+		Candidate.Component->bReservedTick = true;
+		ReservedTime += Candidate.Component->AverageTickCost;
+	}
+}
@@ -0,0 +1,64 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "AIBudgetSubsystem.generated.h"
+
+class UEnemyBehaviorTreeComponent;
+
+/**
+ * Caps behaviour tree work per frame. Enemies in combat and those starved last frame get
+ * reserved slots for the next frame, the rest tick first come first served within the budget
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UAIBudgetSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UAIBudgetSubsystem();
+
+	virtual void Deinitialize() override;
+
+	//runs after the world tick groups and plans the next frame
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterComponent(UEnemyBehaviorTreeComponent* Component);
+	void UnregisterComponent(UEnemyBehaviorTreeComponent* Component);
+
+	//true if the component may tick this frame; counts it as starved otherwise
+	bool CanTick(UEnemyBehaviorTreeComponent* Component);
+
+	//measured cost of a tick that was allowed
+	void ReportTick(UEnemyBehaviorTreeComponent* Component, double Seconds);
+
+private:
+	//2 in attack range, 1 hostile, 0 idle
+	static int32 GetCombatPriority(const UEnemyBehaviorTreeComponent* Component);
+
+	TArray<TWeakObjectPtr<UEnemyBehaviorTreeComponent>> Components;
+
+	//reserved cost not yet spent this frame, in seconds
+	float ReservedTime;
+
+	//behaviour tree time spent this frame, in seconds
+	float SpentTime;
+
+	int32 NumTicked;
+	int32 NumStarved;
+
+	//behaviour tree time allowed per frame
+	UPROPERTY(Config)
+	float BudgetMicroseconds;
+
+	//assumed cost of a component that has never ticked
+	UPROPERTY(Config)
+	float InitialTickCostMicroseconds;
+
+	//weight of the newest sample in the smoothed tick cost
+	UPROPERTY(Config)
+	float CostSmoothing;
+};
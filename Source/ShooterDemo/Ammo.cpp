@@ -20,6 +20,9 @@ AAmmo::AAmmo() {
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
 	AmmoCollisionSphere->SetupAttachment(GetRootComponent());
 	AmmoCollisionSphere->SetSphereRadius(50.f);
+	//WorldDynamic like the area sphere, pawn capsules ignore the Item object type
+	AmmoCollisionSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+	AmmoCollisionSphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
 }
 
 void AAmmo::Tick(float DeltaSeconds) {
@@ -99,3 +102,10 @@ void AAmmo::DisableCustomDepth() {
 	
 	AmmoMesh->SetRenderCustomDepth(false);
 }
+
+void AAmmo::SetPoolActive(bool bActive) {
+	Super::SetPoolActive(bActive);
+
+	//collision sphere is switched off once the ammo has been collected
+	AmmoCollisionSphere->SetCollisionEnabled(bActive ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+}
@@ -51,4 +51,6 @@ public:
 
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
+
+	virtual void SetPoolActive(bool bActive) override;
 };
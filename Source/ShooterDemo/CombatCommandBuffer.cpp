@@ -0,0 +1,44 @@
+// Andrei Nikitin 2022
+
+
+#include "CombatCommandBuffer.h"
+
+FCombatCommandBuffer::FCombatCommandBuffer(int32 InHistorySize) :
+	HistorySize(FMath::Max(InHistorySize, 1)),
+	HistoryHead(0),
+	NextSequence(0)
+{
+	History.Reserve(HistorySize);
+}
+
+void FCombatCommandBuffer::Add(ECombatCommandType Type, float Time, int32 SlotIndex) {
+	FCombatCommand& Command = Pending.AddDefaulted_GetRef();
+	Command.Type = Type;
+	Command.Time = Time;
+	Command.Sequence = NextSequence++;
+	Command.SlotIndex = SlotIndex;
+}
+
+void FCombatCommandBuffer::Consume(TFunctionRef<void(const FCombatCommand&)> Handler) {
+	//handlers may record new commands, those wait for the next step
+	TArray<FCombatCommand> Commands{MoveTemp(Pending)};
+	Pending.Reset();
+
+	for (const FCombatCommand& Command : Commands) {
+		Handler(Command);
+
+		if (History.Num() < HistorySize) {
+			History.Add(Command);
+		} else {
+			History[HistoryHead] = Command;
+			HistoryHead = (HistoryHead + 1) % HistorySize;
+		}
+	}
+}
+
+void FCombatCommandBuffer::GetHistory(TArray<FCombatCommand>& OutCommands) const {
+	OutCommands.Reset(History.Num());
+	for (int32 i = 0; i < History.Num(); i++) {
+		OutCommands.Add(History[(HistoryHead + i) % History.Num()]);
+	}
+}
@@ -0,0 +1,67 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CombatCommandBuffer.generated.h"
+
+UENUM(BlueprintType)
+enum class ECombatCommandType : uint8
+{
+	ECCT_FirePressed UMETA(DisplayName = "FirePressed"),
+	ECCT_FireReleased UMETA(DisplayName = "FireReleased"),
+	ECCT_AimPressed UMETA(DisplayName = "AimPressed"),
+	ECCT_AimReleased UMETA(DisplayName = "AimReleased"),
+	ECCT_Reload UMETA(DisplayName = "Reload"),
+	ECCT_EquipSlot UMETA(DisplayName = "EquipSlot"),
+
+	ECCT_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+USTRUCT(BlueprintType)
+struct FCombatCommand {
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	ECombatCommandType Type{ECombatCommandType::ECCT_MAX};
+
+	//world time at the start of the frame plus the time into the frame the input was handled
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float Time{0.f};
+
+	//increasing per buffer, orders commands received in the same frame
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Sequence{0};
+
+	//inventory slot for equip commands
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 SlotIndex{INDEX_NONE};
+};
+
+/**
+ * Combat input in the order it was received. Input handlers only record commands, the combat
+ * step consumes them, and the last consumed commands are kept for replaying or sending on
+ */
+struct SHOOTERDEMO_API FCombatCommandBuffer {
+	explicit FCombatCommandBuffer(int32 InHistorySize = 64);
+
+	void Add(ECombatCommandType Type, float Time, int32 SlotIndex = INDEX_NONE);
+
+	//calls Handler for every pending command, oldest first, then moves them to the history
+	void Consume(TFunctionRef<void(const FCombatCommand&)> Handler);
+
+	FORCEINLINE bool HasPending() const { return Pending.Num() > 0; }
+
+	//consumed commands, oldest first
+	void GetHistory(TArray<FCombatCommand>& OutCommands) const;
+
+private:
+	TArray<FCombatCommand> Pending;
+
+	//ring of the last consumed commands
+	TArray<FCombatCommand> History;
+	int32 HistorySize;
+	int32 HistoryHead;
+
+	int32 NextSequence;
+};
@@ -0,0 +1,30 @@
+// Andrei Nikitin 2022
+
+
+#include "CombatRandomSubsystem.h"
+
+#include "ShooterDemo.h"
+#include "Misc/CommandLine.h"
+
+bool UCombatRandomSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	if (!Super::ShouldCreateSubsystem(Outer)) {
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UCombatRandomSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("CombatSeed="), Seed)) {
+		Seed = FMath::Rand();
+	}
+	UE_LOG(LogShooterDemo, Log, TEXT("Combat random seed %d (repeat with -CombatSeed=%d)"), Seed, Seed);
+}
+
+FRandomStream UCombatRandomSubsystem::MakeStream(FName StreamName) const {
+	//name hashes are stable between runs, unlike FName indices
+	return FRandomStream(static_cast<int32>(HashCombine(static_cast<uint32>(Seed), FCrc::StrCrc32(*StreamName.ToString()))));
+}
@@ -0,0 +1,31 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatRandomSubsystem.generated.h"
+
+/**
+ * Seed for every combat roll in the world. Taken from -CombatSeed= on the command line (random
+ * otherwise) and logged, so a run can be repeated with the same stuns, hit reacts and drops
+ */
+UCLASS()
+class SHOOTERDEMO_API UCombatRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//only created for game and PIE worlds
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	//stream for one roller, the same name gives the same rolls for the same seed
+	FRandomStream MakeStream(FName StreamName) const;
+
+	FORCEINLINE int32 GetSeed() const { return Seed; }
+
+private:
+	int32 Seed{0};
+};
@@ -3,20 +3,37 @@
 
 #include "Enemy.h"
 
+#include "CombatRandomSubsystem.h"
+#include "EnemyBehaviorTreeComponent.h"
 #include "EnemyController.h"
+#include "EnemyCorpseSubsystem.h"
+#include "EnemyCrowdSubsystem.h"
+#include "EnemyManagerSubsystem.h"
+#include "EnemyPerceptionSubsystem.h"
+#include "EnemySignificanceSubsystem.h"
+#include "HitNumberComponent.h"
+#include "LootSubsystem.h"
 #include "ShooterCharacter.h"
+#include "ShooterDemo.h"
+#include "ShooterNames.h"
+#include "ShooterDemoGameModeBase.h"
+#include "ShooterPlayerController.h"
+#include "AnimationSharingManager.h"
+#include "BrainComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Blueprint/UserWidget.h"
-#include "Components/BoxComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SphereComponent.h"
-#include "Engine/SkeletalMeshSocket.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "IAnimationBudgetAllocator.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "SkeletalMeshComponentBudgeted.h"
 #include "Sound/SoundCue.h"
 
 // Sets default values
-AEnemy::AEnemy() :
+AEnemy::AEnemy(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName)),
 	Health(100.f),
 	MaxHealth(100.f),
 	HealthBarDisplayTime(4.f),
@@ -24,39 +41,48 @@ AEnemy::AEnemy() :
 	HitReactTimeMin(.5f),
 	HitReactTimeMax(1.5f),
 	HitNumberDestroyTime(1.5f),
+	SightRadius(1500.f),
+	PeripheralVisionAngle(70.f),
+	ProximityRadius(300.f),
 	bStunned(false),
 	StunChance(.5f),
 	AttackLFast(TEXT("AttackLFast")),
 	AttackRFast(TEXT("AttackRFast")),
 	AttackL(TEXT("AttackL")),
 	AttackR(TEXT("AttackR")),
+	MeleeSweepRadius(20.f),
 	BaseDamage(40.f),
 	LeftWeaponSocket(TEXT("FX_Trail_L_01")),
 	RightWeaponSocket(TEXT("FX_Trail_R_01")),
 	bCanAttack(true),
 	AttackWaitTime(1.f),
 	bDying(false),
-	DeathTime(4.f)
+	DeathTime(4.f),
+	LootTable(nullptr),
+	LootDropCount(1),
+	bPooled(false),
+	SignificanceTier(INDEX_NONE),
+	TierActorTickInterval(0.f),
+	TierAnimTickInterval(0.f),
+	TierAnimationSignificance(1.f),
+	bAnimationBudgeted(false),
+	bAnimationShared(false),
+	EnemyStateIndex(INDEX_NONE)
 {
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
-	//create the agro sphere
-	AgroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Agro Sphere"));
-	AgroSphere->SetupAttachment(GetRootComponent());
-
 	//create the combat range sphere
 	CombatRangeSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CombatRange"));
 	CombatRangeSphere->SetupAttachment(GetRootComponent());
+	CombatRangeSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+	CombatRangeSphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
 
-	//construct left and right weapon collision boxes
-	LeftWeaponCollision = CreateDefaultSubobject<UBoxComponent>("Left Weapon Box");
-	LeftWeaponCollision->SetupAttachment(GetMesh(), FName("LeftWeaponBone"));
-	
-	RightWeaponCollision = CreateDefaultSubobject<UBoxComponent>("Right Weapon Box");
-	RightWeaponCollision->SetupAttachment(GetMesh(), FName("RightWeaponBone"));
+	//registered and prioritised from the significance tiers instead
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+	BudgetedMesh->SetAutoRegisterWithBudgetAllocator(false);
+	BudgetedMesh->SetAutoCalculateSignificance(false);
 
-	
 }
 
 // Called when the game starts or when spawned
@@ -65,32 +91,94 @@ void AEnemy::BeginPlay()
 	Super::BeginPlay();
 
 	//bind overlap events
-	AgroSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AgroSphereOverlap);
-
 	CombatRangeSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::CombatRangeOverlap);
 	CombatRangeSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::CombatRangeEndOverlap);
 
-	LeftWeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnLeftWeaponOverlap);
-	RightWeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnRightWeaponOverlap);
-
-	//set collision presets for weapon boxes
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	LeftWeaponCollision->SetCollisionObjectType(ECC_WorldDynamic);
-	LeftWeaponCollision->SetCollisionResponseToAllChannels(ECR_Ignore);
-	LeftWeaponCollision->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
-
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	RightWeaponCollision->SetCollisionObjectType(ECC_WorldDynamic);
-	RightWeaponCollision->SetCollisionResponseToAllChannels(ECR_Ignore);
-	RightWeaponCollision->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
-
 	
-	GetMesh()->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	//bullets hit the physics asset, pickup traces ignore it
+	GetMesh()->SetCollisionResponseToChannel(ECC_Weapon, ECR_Block);
+	GetMesh()->SetCollisionResponseToChannel(ECC_Interact, ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Weapon, ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Interact, ECR_Ignore);
 
 	//ignore the camera for mesh and capsule
 	GetMesh()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 	
+	//compile the loot table and warm up its item pools before anything dies
+	ULootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<ULootSubsystem>();
+	if (LootSubsystem && LootTable) {
+		LootSubsystem->RegisterLootTable(LootTable);
+	}
+
+	//named after the actor so the same enemy rolls the same way for the same seed
+	UCombatRandomSubsystem* CombatRandom = GetWorld()->GetSubsystem<UCombatRandomSubsystem>();
+	if (CombatRandom) {
+		CombatStream = CombatRandom->MakeStream(GetFName());
+	}
+
+	RegisterWithSubsystems();
+
+	InitializeAI();
+
+}
+
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	UnregisterFromSubsystems();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemy::RegisterWithSubsystems() {
+	SetAnimationBudgeted(true);
+
+	UEnemyManagerSubsystem* EnemyManager = GetWorld()->GetSubsystem<UEnemyManagerSubsystem>();
+	if (EnemyManager) {
+		EnemyManager->RegisterEnemy(this);
+	}
+
+	UEnemyCrowdSubsystem* CrowdSubsystem = GetWorld()->GetSubsystem<UEnemyCrowdSubsystem>();
+	if (CrowdSubsystem) {
+		CrowdSubsystem->RegisterEnemy(this);
+	}
+
+	UEnemySignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (SignificanceSubsystem) {
+		SignificanceSubsystem->RegisterEnemy(this);
+	}
+
+	UEnemyPerceptionSubsystem* PerceptionSubsystem = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (PerceptionSubsystem) {
+		PerceptionSubsystem->RegisterEnemy(this);
+	}
+}
+
+void AEnemy::UnregisterFromSubsystems() {
+	SetAnimationShared(false);
+	SetAnimationBudgeted(false);
+
+	UEnemyManagerSubsystem* EnemyManager = GetWorld()->GetSubsystem<UEnemyManagerSubsystem>();
+	if (EnemyManager) {
+		EnemyManager->UnregisterEnemy(this);
+	}
+
+	UEnemyCrowdSubsystem* CrowdSubsystem = GetWorld()->GetSubsystem<UEnemyCrowdSubsystem>();
+	if (CrowdSubsystem) {
+		CrowdSubsystem->UnregisterEnemy(this);
+	}
+
+	UEnemySignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (SignificanceSubsystem) {
+		SignificanceSubsystem->UnregisterEnemy(this);
+	}
+
+	UEnemyPerceptionSubsystem* PerceptionSubsystem = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (PerceptionSubsystem) {
+		PerceptionSubsystem->UnregisterEnemy(this);
+	}
+}
+
+void AEnemy::InitializeAI() {
 	//get AI controller
 	EnemyController = Cast<AEnemyController>(GetController());
 	
@@ -99,15 +187,158 @@ void AEnemy::BeginPlay()
 	const FVector WorldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
 
 	if (EnemyController) {
-		EnemyController->GetEnemyBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint"), WorldPatrolPoint);
-
-		EnemyController->GetEnemyBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint2"), WorldPatrolPoint2);	
+		EnemyController->GetEnemyBlackboard().SetPatrolPoints(WorldPatrolPoint, WorldPatrolPoint2);
 
 		EnemyController->RunBehaviorTree(BehaviorTree);
-		EnemyController->GetEnemyBlackboardComponent()->SetValueAsBool(FName("CanAttack"), true);
+		EnemyController->GetEnemyBlackboard().SetCanAttack(true);
 
 	}
+}
 
+void AEnemy::ActivateFromPool(const FTransform& SpawnTransform) {
+	EnemyController = Cast<AEnemyController>(GetController());
+
+	Health = MaxHealth;
+	bDying = false;
+	bStunned = false;
+	bCanAttack = true;
+	bCanHitReact = true;
+	bInAttackRange = false;
+	PerceivedTarget.Reset();
+	//make the significance subsystem apply a tier again
+	SignificanceTier = INDEX_NONE;
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	GetMesh()->bPauseAnims = false;
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	if (EnemyController) {
+		FEnemyBlackboard& EnemyBlackboard = EnemyController->GetEnemyBlackboard();
+		EnemyBlackboard.SetTarget(nullptr);
+		EnemyBlackboard.SetDead(false);
+		EnemyBlackboard.SetStunned(false);
+		EnemyBlackboard.SetInAttackRange(false);
+		EnemyBlackboard.SetCharacterDead(false);
+	}
+
+	RegisterWithSubsystems();
+	InitializeAI();
+}
+
+void AEnemy::DeactivateToPool() {
+	//pooled enemies get their controller after BeginPlay
+	EnemyController = Cast<AEnemyController>(GetController());
+
+	UnregisterFromSubsystems();
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	HideHealthBar();
+
+	if (EnemyController) {
+		EnemyController->StopMovement();
+		if (EnemyController->GetBrainComponent()) {
+			EnemyController->GetBrainComponent()->StopLogic(TEXT("Pooled"));
+		}
+	}
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance) {
+		AnimInstance->StopAllMontages(0.f);
+	}
+	//drop any attack window without a final sweep
+	LeftSwing.bActive = false;
+	RightSwing.bActive = false;
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
+void AEnemy::SetSignificanceTier(int32 Tier, const FEnemySignificanceTier& TierSettings) {
+	if (Tier == SignificanceTier) {
+		return;
+	}
+	SignificanceTier = Tier;
+	TierActorTickInterval = TierSettings.ActorTickInterval;
+	TierAnimTickInterval = TierSettings.AnimTickInterval;
+	TierAnimationSignificance = TierSettings.AnimationSignificance;
+
+	GetCharacterMovement()->SetComponentTickInterval(TierSettings.MovementTickInterval);
+
+	//shared poses only out of combat, montages need the enemy's own anim instance
+	SetAnimationShared(TierSettings.bShareAnimation && !bDying && !PerceivedTarget.IsValid());
+	UpdateSwingTickRate();
+	GetMesh()->VisibilityBasedAnimTickOption = TierSettings.AnimTickOption;
+
+	UEnemyBehaviorTreeComponent* BehaviorTree = EnemyController ? Cast<UEnemyBehaviorTreeComponent>(EnemyController->GetBrainComponent()) : nullptr;
+	if (BehaviorTree) {
+		BehaviorTree->SetMinTickInterval(TierSettings.BehaviorTreeTickInterval);
+	}
+}
+
+void AEnemy::UpdateSwingTickRate() {
+	//sweeps run on the actor tick and follow the animated sockets, throttling either makes hits depend on the tier
+	const bool bSwinging{LeftSwing.bActive || RightSwing.bActive};
+	SetActorTickInterval(bSwinging ? 0.f : TierActorTickInterval);
+
+	if (bAnimationBudgeted) {
+		//the allocator throttles the mesh tick from the significance under load, never skip mid swing
+		IAnimationBudgetAllocator::Get(GetWorld())->SetComponentSignificance(Cast<USkeletalMeshComponentBudgeted>(GetMesh()), TierAnimationSignificance, bSwinging);
+	} else if (!bAnimationShared) {
+		//the anim graph is updated from the mesh tick; delta time accumulates across skipped frames
+		GetMesh()->SetComponentTickInterval(bSwinging ? 0.f : TierAnimTickInterval);
+	}
+}
+
+void AEnemy::SetAnimationBudgeted(bool bBudgeted) {
+	if (bAnimationBudgeted == bBudgeted) {
+		return;
+	}
+
+	IAnimationBudgetAllocator* BudgetAllocator = IAnimationBudgetAllocator::Get(GetWorld());
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+	if (!BudgetAllocator || !BudgetedMesh) {
+		return;
+	}
+
+	bAnimationBudgeted = bBudgeted;
+	if (bBudgeted) {
+		BudgetAllocator->RegisterComponent(BudgetedMesh);
+	} else {
+		BudgetAllocator->UnregisterComponent(BudgetedMesh);
+		BudgetedMesh->SetComponentTickEnabled(true);
+	}
+}
+
+void AEnemy::SetAnimationShared(bool bShare) {
+	if (bAnimationShared == bShare) {
+		return;
+	}
+
+	//only exists when the game mode has an animation sharing setup
+	UAnimationSharingManager* SharingManager = UAnimationSharingManager::GetManagerForWorld(GetWorld());
+	if (!SharingManager) {
+		return;
+	}
+
+	bAnimationShared = bShare;
+	if (bShare) {
+		//the shared instance drives the pose, nothing left to budget
+		SetAnimationBudgeted(false);
+		//unregistered by actor, the handle isn't needed
+		SharingManager->RegisterActor(this, FUpdateActorHandle::CreateLambda([](int32 Handle) {}));
+	} else {
+		SharingManager->UnregisterActor(this);
+		SetAnimationBudgeted(true);
+	}
 }
 
 void AEnemy::ShowHealthBar_Implementation() {
@@ -124,6 +355,13 @@ void AEnemy::Die() {
 	bDying = true;
 	
 	HideHealthBar();
+
+	//only the mesh keeps running, for the death montage on the enemy's own anim instance
+	UnregisterFromSubsystems();
+	SetAnimationBudgeted(true);
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	LeftSwing.bActive = false;
+	RightSwing.bActive = false;
  
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 
@@ -132,10 +370,32 @@ void AEnemy::Die() {
 	}
 
 	if (EnemyController) {
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("Dead"), true);
+		EnemyController->GetEnemyBlackboard().SetDead(true);
 		EnemyController->StopMovement();
+		if (EnemyController->GetBrainComponent()) {
+			EnemyController->GetBrainComponent()->StopLogic(TEXT("Dead"));
+		}
+	}
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	//drops are spawned from the item pool over the next frames
+	ULootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<ULootSubsystem>();
+	if (LootSubsystem && LootTable) {
+		const FVector FeetLocation{GetActorLocation() - FVector(0.f, 0.f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight())};
+		LootSubsystem->RequestDrop(LootTable, FeetLocation, LootDropCount);
+	}
+
+	//corpses past the budget, possibly this one, are released on the next tick
+	UEnemyCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UEnemyCorpseSubsystem>();
+	if (CorpseSubsystem) {
+		CorpseSubsystem->RegisterCorpse(this);
 	}
-	
 }
 
 void AEnemy::PlayHitMontage(FName Section, float PlayRate) {
@@ -148,8 +408,13 @@ void AEnemy::PlayHitMontage(FName Section, float PlayRate) {
 		}
 		bCanHitReact = false;
 		//delay between hits; preventing spamming and robotic behaviour
-		const float HitReactTime{FMath::FRandRange(HitReactTimeMin, HitReactTimeMax)};
-		GetWorldTimerManager().SetTimer(HitReactTimer, this, &AEnemy::ResetHitReactTimer, HitReactTime);
+		const float HitReactTime{CombatStream.FRandRange(HitReactTimeMin, HitReactTimeMax)};
+		UEnemyManagerSubsystem* EnemyManager = GetWorld()->GetSubsystem<UEnemyManagerSubsystem>();
+		if (EnemyManager && EnemyStateIndex != INDEX_NONE) {
+			EnemyManager->StartHitReactCooldown(this, HitReactTime);
+		} else {
+			GetWorldTimerManager().SetTimer(HitReactTimer, this, &AEnemy::ResetHitReactTimer, HitReactTime);
+		}
 	}
 
 }
@@ -159,45 +424,24 @@ void AEnemy::ResetHitReactTimer() {
 }
 
 void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location) {
-	HitNumbers.Add(HitNumber, Location);
-
-	FTimerHandle HitNumberTimer;
-	FTimerDelegate HitNumberDelegate;
-	HitNumberDelegate.BindUFunction(this, FName("DestroyHitNumber"), HitNumber);
-	GetWorld()->GetTimerManager().SetTimer(HitNumberTimer, HitNumberDelegate, HitNumberDestroyTime, false);
-}
-
-void AEnemy::DestroyHitNumber(UUserWidget* HitNumber) {
-	HitNumbers.Remove(HitNumber);
-	HitNumber->RemoveFromParent();
-}
-
-void AEnemy::UpdateHitNumbers() {
-	for (auto &HitPair : HitNumbers) {
-		UUserWidget* HitNumber{HitPair.Key};
-		const FVector Location{HitPair.Value};
-		FVector2D ScreenPosition{FVector2D::ZeroVector};
-
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), Location, ScreenPosition);
-		HitNumber->SetPositionInViewport(ScreenPosition);
+	const AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(GetWorld()->GetFirstPlayerController());
+	UHitNumberComponent* HitNumberComponent = PlayerController ? PlayerController->GetHitNumberComponent() : nullptr;
+	if (HitNumberComponent) {
+		HitNumberComponent->AddHitNumberWidget(HitNumber, Location, HitNumberDestroyTime);
+	} else if (HitNumber) {
+		HitNumber->RemoveFromParent();
 	}
 }
 
-void AEnemy::AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) {
-
-	if (!OtherActor) {
-		return;
+void AEnemy::SetPerceivedTarget(AActor* Target) {
+	PerceivedTarget = Target;
+	if (Target) {
+		SetAnimationShared(false);
 	}
-	AShooterCharacter* Character = Cast<AShooterCharacter>(OtherActor);
 
-	if(Character) {
-		if (EnemyController) {
-			if (EnemyController->GetBlackboardComponent()) {
-				//set the value of the target blackboard key
-				EnemyController->GetBlackboardComponent()->SetValueAsObject(TEXT("Target"), Character);
-			}
-		}
+	if (EnemyController) {
+		//set the value of the target blackboard key
+		EnemyController->GetEnemyBlackboard().SetTarget(Target);
 	}
 }
 
@@ -205,7 +449,7 @@ void AEnemy::SetStunned(bool bState) {
 	bStunned = bState;
 
 	if (EnemyController) {
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("Stunned"), bState);
+		EnemyController->GetEnemyBlackboard().SetStunned(bState);
 	}
 }
 
@@ -222,7 +466,7 @@ void AEnemy::CombatRangeOverlap(UPrimitiveComponent* OverlappedComponent, AActor
 		bInAttackRange = true;
 
 		if (EnemyController) {
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), true);
+			EnemyController->GetEnemyBlackboard().SetInAttackRange(true);
 		}
 	}
 	
@@ -241,7 +485,7 @@ void AEnemy::CombatRangeEndOverlap(UPrimitiveComponent* OverlappedComponent, AAc
 		bInAttackRange = false;
 	
 		if (EnemyController) {
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), false);
+			EnemyController->GetEnemyBlackboard().SetInAttackRange(false);
 		}
 	}
 }
@@ -254,15 +498,20 @@ void AEnemy::PlayAttackMontage(FName Section, float PlayRate) {
 		AnimInstance->Montage_JumpToSection(Section, AttackMontage);
 	}
 	bCanAttack = false;
-	GetWorldTimerManager().SetTimer(AttackWaitTimer, this, &AEnemy::ResetCanAttack, AttackWaitTime);
+	UEnemyManagerSubsystem* EnemyManager = GetWorld()->GetSubsystem<UEnemyManagerSubsystem>();
+	if (EnemyManager && EnemyStateIndex != INDEX_NONE) {
+		EnemyManager->StartAttackCooldown(this, AttackWaitTime);
+	} else {
+		GetWorldTimerManager().SetTimer(AttackWaitTimer, this, &AEnemy::ResetCanAttack, AttackWaitTime);
+	}
 	if (EnemyController) {
-		EnemyController->GetEnemyBlackboardComponent()->SetValueAsBool(FName("CanAttack"), false);
+		EnemyController->GetEnemyBlackboard().SetCanAttack(false);
 	}
 }
 
 FName AEnemy::GetAttackSectionName() {
 	FName SectionName;
-	const int32 Section = FMath::RandRange(1, 4);
+	const int32 Section = CombatStream.RandRange(1, 4);
 	switch (Section) {
 	case 1:
 		SectionName = AttackLFast;
@@ -281,43 +530,65 @@ FName AEnemy::GetAttackSectionName() {
 	return  SectionName;
 }
 
-void AEnemy::OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) {
+void AEnemy::ActivateLeftWeapon() {
+	BeginSwing(LeftSwing, LeftWeaponSocket);
+}
+void AEnemy::DeactivateLeftWeapon() {
+	EndSwing(LeftSwing);
+}
+void AEnemy::ActivateRightWeapon() {
+	BeginSwing(RightSwing, RightWeaponSocket);
+}
+void AEnemy::DeactivateRightWeapon() {
+	EndSwing(RightSwing);
+}
 
-	AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
+void AEnemy::BeginSwing(FMeleeSwing& Swing, FName SocketName) {
+	Swing.bActive = true;
+	//the socket properties are editable, only a changed name is looked up again
+	Swing.Socket.SetName(SocketName);
+	FTransform SocketTransform;
+	Swing.Socket.GetTransform(GetMesh(), SocketTransform);
+	Swing.PreviousLocation = SocketTransform.GetLocation();
+	Swing.HitActors.Reset();
+	UpdateSwingTickRate();
+}
 
-	if(ShooterCharacter) {
-		CauseDamage(ShooterCharacter);
-		SpawnBlood(ShooterCharacter, LeftWeaponSocket);
-		StunCharacter(ShooterCharacter);
+void AEnemy::EndSwing(FMeleeSwing& Swing) {
+	if (!Swing.bActive) {
+		return;
 	}
+	//cover the last bit of the swing since the previous tick
+	SweepSwing(Swing);
+	Swing.bActive = false;
+	UpdateSwingTickRate();
 }
 
-void AEnemy::OnRightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) {
+void AEnemy::SweepSwing(FMeleeSwing& Swing) {
+	FTransform SocketTransform;
+	Swing.Socket.GetTransform(GetMesh(), SocketTransform);
+	const FVector CurrentLocation{SocketTransform.GetLocation()};
+
+	TArray<FHitResult> HitResults;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(EnemyMeleeSweep), false, this);
+	GetWorld()->SweepMultiByObjectType(HitResults, Swing.PreviousLocation, CurrentLocation, FQuat::Identity,
+		FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(MeleeSweepRadius), QueryParams);
+	Swing.PreviousLocation = CurrentLocation;
+
+	for (const FHitResult& HitResult : HitResults) {
+		AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(HitResult.GetActor());
+		//capsule and mesh can both be hit, damage once per swing
+		if (!ShooterCharacter || Swing.HitActors.Contains(ShooterCharacter)) {
+			continue;
+		}
+		Swing.HitActors.Add(ShooterCharacter);
 
-	AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
- 
-	if(ShooterCharacter) {
 		CauseDamage(ShooterCharacter);
-		SpawnBlood(ShooterCharacter, RightWeaponSocket);
+		SpawnBlood(ShooterCharacter, SocketTransform);
 		StunCharacter(ShooterCharacter);
 	}
 }
 
-void AEnemy::ActivateLeftWeapon() {
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-}
-void AEnemy::DeactivateLeftWeapon() {
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-}
-void AEnemy::ActivateRightWeapon() {
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-}
-void AEnemy::DeactivateRightWeapon() {
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-}
-
 void AEnemy::CauseDamage(AShooterCharacter* Character) {
 	
 	
@@ -328,19 +599,15 @@ void AEnemy::CauseDamage(AShooterCharacter* Character) {
 	}
 }
 
-void AEnemy::SpawnBlood(AShooterCharacter* Victim, FName SocketName) {
-	const USkeletalMeshSocket* TipSocket{ GetMesh()->GetSocketByName(SocketName)};
-	if (TipSocket) {
-		const FTransform SocketTransform{ TipSocket->GetSocketTransform(GetMesh()) };
-		if (Victim->GetBloodParticles()) {
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Victim->GetBloodParticles(), SocketTransform);
-		}
+void AEnemy::SpawnBlood(AShooterCharacter* Victim, const FTransform& SocketTransform) {
+	if (Victim->GetBloodParticles()) {
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Victim->GetBloodParticles(), SocketTransform);
 	}
 }
 
 void AEnemy::StunCharacter(AShooterCharacter* Victim) {
 	if (Victim) {
-		const float Stun{ FMath::FRandRange(0.f, 1.f)};
+		const float Stun{ CombatStream.FRandRange(0.f, 1.f)};
 		if (Stun <= Victim->GetStunChance()) {
 			Victim->Stun();
 		}
@@ -350,7 +617,16 @@ void AEnemy::StunCharacter(AShooterCharacter* Victim) {
 void AEnemy::ResetCanAttack() {
 	bCanAttack = true;
 	if (EnemyController) {
-		EnemyController->GetEnemyBlackboardComponent()->SetValueAsBool(FName("CanAttack"), true);
+		EnemyController->GetEnemyBlackboard().SetCanAttack(true);
+	}
+}
+
+void AEnemy::OnStateTransition(EEnemyStateFlags Transitions) {
+	if (EnumHasAnyFlags(Transitions, EEnemyStateFlags::CanHitReact)) {
+		ResetHitReactTimer();
+	}
+	if (EnumHasAnyFlags(Transitions, EEnemyStateFlags::CanAttack)) {
+		ResetCanAttack();
 	}
 }
 
@@ -358,12 +634,21 @@ void AEnemy::FinishDeath() {
 
 	GetMesh()->bPauseAnims = true;
 
+	//nothing left to update on a paused corpse
+	SetAnimationBudgeted(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
 	GetWorldTimerManager().SetTimer(DeathTimer, this, &AEnemy::DestroyEnemy, DeathTime);
 	
 }
 
 void AEnemy::DestroyEnemy() {
-	Destroy();
+	AShooterDemoGameModeBase* GameMode = bPooled ? Cast<AShooterDemoGameModeBase>(UGameplayStatics::GetGameMode(this)) : nullptr;
+	if (GameMode) {
+		GameMode->ReleaseEnemy(this);
+	} else {
+		Destroy();
+	}
 }
 
 // Called every frame
@@ -371,7 +656,12 @@ void AEnemy::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	UpdateHitNumbers();
+	if (LeftSwing.bActive) {
+		SweepSwing(LeftSwing);
+	}
+	if (RightSwing.bActive) {
+		SweepSwing(RightSwing);
+	}
 }
 
 // Called to bind functionality to input
@@ -398,9 +688,7 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 	AActor* DamageCauser) {
 
 	//set target blackboard key to agro the character
-	if (EnemyController) {
-		EnemyController->GetEnemyBlackboardComponent()->SetValueAsObject(FName("Target"), DamageCauser);
-	}
+	SetPerceivedTarget(DamageCauser);
 
 	Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 
@@ -418,10 +706,10 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 	ShowHealthBar();
 
 	//determine if stuns
-	const float Stunned{FMath::FRandRange(0, 1.f)};
+	const float Stunned{CombatStream.FRandRange(0.f, 1.f)};
 	if (Stunned <= StunChance) {
 		//stun the enemy
-		PlayHitMontage(FName("HitReactFront")); 
+		PlayHitMontage(ShooterNames::HitReactFrontSection);
 		SetStunned(true);		
 	}
 
@@ -4,21 +4,50 @@
 
 #include "CoreMinimal.h"
 #include "BulletHitInterface.h"
+#include "MeshSocketHandle.h"
 #include "GameFramework/Character.h"
 #include "Enemy.generated.h"
 
+struct FEnemySignificanceTier;
+enum class EEnemyStateFlags : uint8;
+
+//one weapon's attack window, swept from the socket's previous location every tick
+struct FMeleeSwing {
+	bool bActive{false};
+	FVector PreviousLocation{FVector::ZeroVector};
+	//weapon socket, found once per mesh
+	FMeshSocketHandle Socket;
+	//actors already damaged by this swing
+	TArray<AActor*, TInlineAllocator<4>> HitActors;
+};
+
 UCLASS()
 class SHOOTERDEMO_API AEnemy : public ACharacter, public IBulletHitInterface
 {
 	GENERATED_BODY()
 
+	//owns the packed copy of the combat state and the cooldowns
+	friend class UEnemyManagerSubsystem;
+
 public:
 	// Sets default values for this character's properties
-	AEnemy();
+	AEnemy(const FObjectInitializer& ObjectInitializer);
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//sets the patrol points and starts the behaviour tree
+	void InitializeAI();
+
+	//significance, perception and crowd subsystems
+	void RegisterWithSubsystems();
+	void UnregisterFromSubsystems();
+
+	//hands the mesh between the animation budget allocator and the animation sharing manager
+	void SetAnimationBudgeted(bool bBudgeted);
+	void SetAnimationShared(bool bShare);
 
 	UFUNCTION(BlueprintNativeEvent)
 	void ShowHealthBar();
@@ -33,18 +62,10 @@ protected:
 
 	void ResetHitReactTimer();
 
+	//hands a hit number widget created in blueprint to the player's hit number manager
 	UFUNCTION(BlueprintCallable)
 	void StoreHitNumber(UUserWidget* HitNumber, FVector Location);
 
-	UFUNCTION()
-	void DestroyHitNumber(UUserWidget* HitNumber);
-
-	void UpdateHitNumbers();
-
-	//called when smth overlaps with the agro sphere
-	UFUNCTION()
-	void AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
 	UFUNCTION(BlueprintCallable)
 	void SetStunned(bool bState);
 
@@ -60,13 +81,17 @@ protected:
 	UFUNCTION(BlueprintPure)
 	FName GetAttackSectionName();
 
-	UFUNCTION()
-	void OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	//starts / ends the attack window of a weapon
+	void BeginSwing(FMeleeSwing& Swing, FName SocketName);
+	void EndSwing(FMeleeSwing& Swing);
 
-	UFUNCTION()
-	void OnRightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	//sweeps the weapon from its previous to its current socket location and damages new hits
+	void SweepSwing(FMeleeSwing& Swing);
+
+	//full rate actor and animation ticks while a swing is active, the significance tier's rates otherwise
+	void UpdateSwingTickRate();
 
-	//activate / deactivate collision for weapon boxes
+	//activate / deactivate melee sweeps for the weapons, called from attack anim notifies
 	UFUNCTION(BlueprintCallable)
 	void ActivateLeftWeapon();
 	UFUNCTION(BlueprintCallable)
@@ -77,18 +102,18 @@ protected:
 	void DeactivateRightWeapon();
 
 	void CauseDamage(class AShooterCharacter* Character);
-	void SpawnBlood(AShooterCharacter* Victim, FName SocketName);
+	void SpawnBlood(AShooterCharacter* Victim, const FTransform& SocketTransform);
 
 	//attempt to stun character
 	void StunCharacter(AShooterCharacter* Victim);
 
 	void ResetCanAttack();
 
+	//called by the enemy manager for the state bits that became set this frame
+	void OnStateTransition(EEnemyStateFlags Transitions);
+
 	UFUNCTION(BlueprintCallable)
 	void FinishDeath();
-
-	UFUNCTION()
-	void DestroyEnemy();
 	
 private:
 
@@ -132,10 +157,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float HitReactTimeMax;
 
-	//map to store hit number widgets and their hit locations
-	UPROPERTY(VisibleAnywhere, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> HitNumbers;
-
 	//time before hit number is removed from the screen
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float HitNumberDestroyTime;
@@ -155,9 +176,20 @@ private:
 	UPROPERTY()
 	class AEnemyController* EnemyController;
 
-	//overlap sphere for when the enemy becomes hostile
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
-	class USphereComponent* AgroSphere;
+	//how far the enemy can see a target and become hostile
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Perception", meta = (AllowPrivateAccess = "true"))
+	float SightRadius;
+
+	//half angle of the view cone in degrees
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Perception", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "180.0"))
+	float PeripheralVisionAngle;
+
+	//targets closer than this are noticed even outside the view cone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Perception", meta = (AllowPrivateAccess = "true"))
+	float ProximityRadius;
+
+	//target seen by the perception subsystem
+	TWeakObjectPtr<AActor> PerceivedTarget;
 
 	//true when playing the get hit animation
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
@@ -173,7 +205,7 @@ private:
 
 	//sphere for attack range
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
-	USphereComponent* CombatRangeSphere;
+	class USphereComponent* CombatRangeSphere;
 
 	//montage containing different attacks
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
@@ -185,11 +217,12 @@ private:
 	FName AttackL;
 	FName AttackR;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	class UBoxComponent* LeftWeaponCollision;
+	FMeleeSwing LeftSwing;
+	FMeleeSwing RightSwing;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	UBoxComponent* RightWeaponCollision;
+	//radius of the sphere swept along the weapon sockets
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float MeleeSweepRadius;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
 	float BaseDamage;
@@ -219,6 +252,38 @@ private:
 	//time after death until destroy
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
 	float DeathTime;
+
+	//loot table (FLootTableRow) rolled when the enemy dies
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loot", meta = (AllowPrivateAccess = "true"))
+	class UDataTable* LootTable;
+
+	//number of rolls on the loot table on death
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loot", meta = (AllowPrivateAccess = "true"))
+	int32 LootDropCount;
+
+	//owned by the game mode's enemy pool, returned to it instead of destroyed
+	bool bPooled;
+
+	//level of detail assigned by the significance subsystem, 0 is full fidelity
+	UPROPERTY(VisibleAnywhere, Category = "Significance", meta = (AllowPrivateAccess = "true"))
+	int32 SignificanceTier;
+
+	//rates of the current tier, overridden to full rate during melee swings
+	float TierActorTickInterval;
+	float TierAnimTickInterval;
+	float TierAnimationSignificance;
+
+	//registered with the animation budget allocator, which then owns the mesh tick rate
+	bool bAnimationBudgeted;
+
+	//following a shared pose of the animation sharing manager
+	bool bAnimationShared;
+
+	//slot in the enemy manager's arrays, INDEX_NONE while not managed
+	int32 EnemyStateIndex;
+
+	//stun, hit react and attack rolls, seeded from the combat random subsystem
+	FRandomStream CombatStream;
 	
 public:	
 	// Called every frame
@@ -237,4 +302,36 @@ public:
 	void ShowHitNumber(int32 Damage, FVector HitLocation, bool bHeadShot);
 
 	FORCEINLINE UBehaviorTree* GetBehaviourTree() const { return BehaviorTree; }
+
+	FORCEINLINE int32 GetSignificanceTier() const { return SignificanceTier; }
+
+	FORCEINLINE bool IsDying() const { return bDying; }
+
+	FORCEINLINE bool IsPooled() const { return bPooled; }
+	FORCEINLINE void SetPooled(bool bInPool) { bPooled = bInPool; }
+
+	//resets the enemy, places it and starts its AI
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	//stops AI, movement and animation and hides the enemy until it is reused
+	void DeactivateToPool();
+
+	//returns the corpse to its pool, or destroys it if it isn't pooled
+	UFUNCTION()
+	void DestroyEnemy();
+
+	FORCEINLINE bool IsInAttackRange() const { return bInAttackRange; }
+
+	FORCEINLINE float GetSightRadius() const { return SightRadius; }
+	FORCEINLINE float GetPeripheralVisionAngle() const { return PeripheralVisionAngle; }
+	FORCEINLINE float GetProximityRadius() const { return ProximityRadius; }
+
+	//alive and not yet hostile towards a target
+	FORCEINLINE bool CanSenseTargets() const { return !bDying && !PerceivedTarget.IsValid(); }
+
+	//called by the perception subsystem once the enemy has line of sight to a target
+	void SetPerceivedTarget(AActor* Target);
+
+	//applies the update rates of a significance tier to the actor, movement, mesh and behaviour tree
+	void SetSignificanceTier(int32 Tier, const FEnemySignificanceTier& TierSettings);
 };
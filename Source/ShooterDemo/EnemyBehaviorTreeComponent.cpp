@@ -0,0 +1,55 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemyBehaviorTreeComponent.h"
+
+#include "AIBudgetSubsystem.h"
+
+UEnemyBehaviorTreeComponent::UEnemyBehaviorTreeComponent(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer),
+	PendingDeltaTime(0.f),
+	MinTickInterval(0.f),
+	AverageTickCost(0.f),
+	FramesStarved(0),
+	bReservedTick(false)
+{
+
+}
+
+void UEnemyBehaviorTreeComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	UAIBudgetSubsystem* BudgetSubsystem = GetWorld()->GetSubsystem<UAIBudgetSubsystem>();
+	if (BudgetSubsystem) {
+		BudgetSubsystem->RegisterComponent(this);
+	}
+}
+
+void UEnemyBehaviorTreeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	UAIBudgetSubsystem* BudgetSubsystem = GetWorld()->GetSubsystem<UAIBudgetSubsystem>();
+	if (BudgetSubsystem) {
+		BudgetSubsystem->UnregisterComponent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UEnemyBehaviorTreeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) {
+	PendingDeltaTime += DeltaTime;
+	if (PendingDeltaTime < MinTickInterval) {
+		return;
+	}
+
+	UAIBudgetSubsystem* BudgetSubsystem = GetWorld()->GetSubsystem<UAIBudgetSubsystem>();
+	if (BudgetSubsystem && !BudgetSubsystem->CanTick(this)) {
+		return;
+	}
+
+	const double StartTime{FPlatformTime::Seconds()};
+	Super::TickComponent(PendingDeltaTime, TickType, ThisTickFunction);
+	PendingDeltaTime = 0.f;
+
+	if (BudgetSubsystem) {
+		BudgetSubsystem->ReportTick(this, FPlatformTime::Seconds() - StartTime);
+	}
+}
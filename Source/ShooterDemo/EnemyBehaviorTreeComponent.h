@@ -0,0 +1,48 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "EnemyBehaviorTreeComponent.generated.h"
+
+/**
+ * Behaviour tree component that asks the AI budget subsystem before running its tick;
+ * skipped ticks accumulate their delta time for the next one that is allowed. The enemy's
+ * significance tier sets a minimum time between ticks the same way
+ */
+UCLASS()
+class SHOOTERDEMO_API UEnemyBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyBehaviorTreeComponent(const FObjectInitializer& ObjectInitializer);
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//the tree sets its own tick interval after every tick, so the tier's rate is a minimum enforced here
+	FORCEINLINE void SetMinTickInterval(float Interval) { MinTickInterval = FMath::Max(Interval, 0.f); }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	friend class UAIBudgetSubsystem;
+
+	//delta time of ticks skipped for budget or the minimum interval
+	float PendingDeltaTime;
+
+	//seconds of pending delta time needed before the tree runs
+	float MinTickInterval;
+
+	//smoothed cost of one tick in seconds
+	float AverageTickCost;
+
+	//consecutive ticks denied by the budget
+	int32 FramesStarved;
+
+	//reserved a slot in the next frame's budget
+	bool bReservedTick;
+};
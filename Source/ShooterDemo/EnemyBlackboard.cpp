@@ -0,0 +1,103 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemyBlackboard.h"
+
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "UObject/ObjectKey.h"
+
+const FEnemyBlackboardKeys& FEnemyBlackboardKeys::Get(const UBlackboardData* BlackboardAsset) {
+	check(IsInGameThread());
+
+	//game thread only; object keys so a reused address never matches a dead asset
+	static TMap<FObjectKey, FEnemyBlackboardKeys> KeysByAsset;
+
+	FEnemyBlackboardKeys* CachedKeys = KeysByAsset.Find(BlackboardAsset);
+	if (CachedKeys) {
+		return *CachedKeys;
+	}
+
+	FEnemyBlackboardKeys& NewKeys = KeysByAsset.Add(BlackboardAsset);
+	NewKeys.Target = BlackboardAsset->GetKeyID(TEXT("Target"));
+	NewKeys.CanAttack = BlackboardAsset->GetKeyID(TEXT("CanAttack"));
+	NewKeys.Stunned = BlackboardAsset->GetKeyID(TEXT("Stunned"));
+	NewKeys.InAttackRange = BlackboardAsset->GetKeyID(TEXT("InAttackRange"));
+	NewKeys.Dead = BlackboardAsset->GetKeyID(TEXT("Dead"));
+	NewKeys.CharacterDead = BlackboardAsset->GetKeyID(TEXT("CharacterDead"));
+	NewKeys.PatrolPoint = BlackboardAsset->GetKeyID(TEXT("PatrolPoint"));
+	NewKeys.PatrolPoint2 = BlackboardAsset->GetKeyID(TEXT("PatrolPoint2"));
+	return NewKeys;
+}
+
+void FEnemyBlackboard::Initialize(UBlackboardComponent* InBlackboard) {
+	BlackboardComponent = InBlackboard;
+	KeysAsset = nullptr;
+	GetKeys();
+}
+
+const FEnemyBlackboardKeys* FEnemyBlackboard::GetKeys() {
+	const UBlackboardComponent* Blackboard = BlackboardComponent.Get();
+	const UBlackboardData* BlackboardAsset = Blackboard ? Blackboard->GetBlackboardAsset() : nullptr;
+	if (!BlackboardAsset) {
+		return nullptr;
+	}
+
+	if (BlackboardAsset != KeysAsset) {
+		KeysAsset = BlackboardAsset;
+		Keys = FEnemyBlackboardKeys::Get(BlackboardAsset);
+	}
+	return &Keys;
+}
+
+void FEnemyBlackboard::SetTarget(UObject* Target) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Object>(BlackboardKeys->Target, Target);
+	}
+}
+
+void FEnemyBlackboard::SetCanAttack(bool bCanAttack) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Bool>(BlackboardKeys->CanAttack, bCanAttack);
+	}
+}
+
+void FEnemyBlackboard::SetStunned(bool bStunned) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Bool>(BlackboardKeys->Stunned, bStunned);
+	}
+}
+
+void FEnemyBlackboard::SetInAttackRange(bool bInAttackRange) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Bool>(BlackboardKeys->InAttackRange, bInAttackRange);
+	}
+}
+
+void FEnemyBlackboard::SetDead(bool bDead) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Bool>(BlackboardKeys->Dead, bDead);
+	}
+}
+
+void FEnemyBlackboard::SetCharacterDead(bool bCharacterDead) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Bool>(BlackboardKeys->CharacterDead, bCharacterDead);
+	}
+}
+
+void FEnemyBlackboard::SetPatrolPoints(const FVector& PatrolPoint, const FVector& PatrolPoint2) {
+	const FEnemyBlackboardKeys* BlackboardKeys = GetKeys();
+	if (BlackboardKeys) {
+		SetValue<UBlackboardKeyType_Vector>(BlackboardKeys->PatrolPoint, PatrolPoint);
+		SetValue<UBlackboardKeyType_Vector>(BlackboardKeys->PatrolPoint2, PatrolPoint2);
+	}
+}
@@ -0,0 +1,63 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "BehaviorTree/BlackboardComponent.h"
+
+class UBlackboardData;
+
+//key ids of the enemy blackboard, resolved once per blackboard asset
+struct FEnemyBlackboardKeys {
+	FBlackboard::FKey Target{FBlackboard::InvalidKey};
+	FBlackboard::FKey CanAttack{FBlackboard::InvalidKey};
+	FBlackboard::FKey Stunned{FBlackboard::InvalidKey};
+	FBlackboard::FKey InAttackRange{FBlackboard::InvalidKey};
+	FBlackboard::FKey Dead{FBlackboard::InvalidKey};
+	FBlackboard::FKey CharacterDead{FBlackboard::InvalidKey};
+	FBlackboard::FKey PatrolPoint{FBlackboard::InvalidKey};
+	FBlackboard::FKey PatrolPoint2{FBlackboard::InvalidKey};
+
+	//cached keys for the asset, resolved by name the first time it is seen
+	static const FEnemyBlackboardKeys& Get(const UBlackboardData* BlackboardAsset);
+};
+
+/**
+ * Typed writes to an enemy's blackboard through cached key ids;
+ * writes that don't change the stored value are skipped
+ */
+class SHOOTERDEMO_API FEnemyBlackboard
+{
+public:
+	void Initialize(UBlackboardComponent* InBlackboard);
+
+	void SetTarget(UObject* Target);
+	void SetCanAttack(bool bCanAttack);
+	void SetStunned(bool bStunned);
+	void SetInAttackRange(bool bInAttackRange);
+	void SetDead(bool bDead);
+	void SetCharacterDead(bool bCharacterDead);
+	void SetPatrolPoints(const FVector& PatrolPoint, const FVector& PatrolPoint2);
+
+private:
+	//keys for the asset the blackboard currently uses, re-resolved if the asset changed; null without a blackboard
+	const FEnemyBlackboardKeys* GetKeys();
+
+	template<class TDataClass>
+	void SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value) {
+		if (KeyID == FBlackboard::InvalidKey) {
+			return;
+		}
+		UBlackboardComponent* Blackboard = BlackboardComponent.Get();
+		if (Blackboard->GetValue<TDataClass>(KeyID) != Value) {
+			Blackboard->SetValue<TDataClass>(KeyID, Value);
+		}
+	}
+
+	TWeakObjectPtr<UBlackboardComponent> BlackboardComponent;
+
+	//copied out of the shared cache, which may reallocate as assets are added
+	const UBlackboardData* KeysAsset{nullptr};
+	FEnemyBlackboardKeys Keys;
+};
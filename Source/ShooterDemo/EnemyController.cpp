@@ -3,14 +3,19 @@
 
 #include "EnemyController.h"
 
-#include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Enemy.h"
+#include "EnemyBehaviorTreeComponent.h"
+#include "NavPathCacheSubsystem.h"
+#include "PathRequestQueueSubsystem.h"
 #include "BehaviorTree/BehaviorTree.h"
+#include "Navigation/PathFollowingComponent.h"
 
 AEnemyController::AEnemyController() {
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("Blackboard Component"));
-	BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>("Behaviour Tree Component");
+	BehaviorTreeComponent = CreateDefaultSubobject<UEnemyBehaviorTreeComponent>("Behaviour Tree Component");
+	//RunBehaviorTree reuses the brain component instead of creating its own
+	BrainComponent = BehaviorTreeComponent;
 
 	//if false causes an error
 	check(BlackboardComponent);
@@ -27,9 +32,60 @@ void AEnemyController::OnPossess(APawn* InPawn) {
 
 	AEnemy* Enemy = Cast<AEnemy>(InPawn);
 	if (Enemy) {
-		if (Enemy->GetBehaviourTree()) {
+		if (Enemy->GetBehaviourTree() && Enemy->GetBehaviourTree()->BlackboardAsset) {
 			BlackboardComponent->InitializeBlackboard(*(Enemy->GetBehaviourTree()->BlackboardAsset));
 		}
 	}
-	
+
+	EnemyBlackboard.Initialize(BlackboardComponent);
+}
+
+void AEnemyController::FindPathForMoveRequest(const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) const {
+	//paths to actors follow a moving goal and aren't worth caching
+	UNavPathCacheSubsystem* PathCache = MoveRequest.IsMoveToActorRequest() ? nullptr : GetWorld()->GetSubsystem<UNavPathCacheSubsystem>();
+	if (PathCache && PathCache->FindPath(Query, OutPath)) {
+		return;
+	}
+
+	//many enemies acquiring the player in one frame would otherwise all path synchronously
+	UPathRequestQueueSubsystem* PathQueue = GetWorld()->GetSubsystem<UPathRequestQueueSubsystem>();
+	if (PathQueue && PathQueue->IsEnabled()) {
+		OutPath = PathQueue->RequestPath(Query, FOnQueuedPathFinished::CreateUObject(this, &AEnemyController::OnQueuedPathFinished,
+			TWeakObjectPtr<AActor>(MoveRequest.GetGoalActor())));
+		if (OutPath.IsValid()) {
+			return;
+		}
+	}
+
+	Super::FindPathForMoveRequest(MoveRequest, Query, OutPath);
+
+	if (PathCache) {
+		PathCache->StorePath(Query, OutPath);
+	}
+}
+
+void AEnemyController::OnQueuedPathFinished(const FPathFindingQuery& Query, FNavPathSharedPtr Path, bool bSuccess, TWeakObjectPtr<AActor> GoalActor) const {
+	UPathFollowingComponent* PathFollowing = GetPathFollowingComponent();
+	const bool bFollowingPath{PathFollowing && PathFollowing->GetPath() == Path};
+
+	if (!bSuccess) {
+		if (bFollowingPath) {
+			PathFollowing->AbortMove(*this, FPathFollowingResultFlags::InvalidPath);
+		}
+		return;
+	}
+
+	//same setup the synchronous path gets
+	if (GoalActor.IsValid()) {
+		Path->SetGoalActorObservation(*GoalActor, 100.f);
+	} else {
+		UNavPathCacheSubsystem* PathCache = GetWorld()->GetSubsystem<UNavPathCacheSubsystem>();
+		if (PathCache) {
+			PathCache->StorePath(Query, Path);
+		}
+	}
+	Path->EnableRecalculationOnInvalidation(true);
+
+	//wakes up path following waiting on this path
+	Path->DoneUpdating(ENavPathEvent::UpdatedDueToNavigationChanged);
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "EnemyBlackboard.h"
 #include "EnemyController.generated.h"
 
 /**
@@ -20,7 +21,12 @@ public:
 protected:
 	virtual void OnPossess(APawn* InPawn) override;
 
+	//patrol legs to fixed locations go through the shared path cache, misses through the path request queue
+	virtual void FindPathForMoveRequest(const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) const override;
+
 private:
+	//path following waits on the path until the queue fills it
+	void OnQueuedPathFinished(const FPathFindingQuery& Query, FNavPathSharedPtr Path, bool bSuccess, TWeakObjectPtr<AActor> GoalActor) const;
 
 	//blackboard component for this enemy
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behaviour", meta = (AllowPrivateAccess = "true"))
@@ -28,8 +34,13 @@ private:
 
 	//Behaviour Tree component for this enemy
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behaviour", meta = (AllowPrivateAccess = "true"))
-	class UBehaviorTreeComponent* BehaviorTreeComponent;
+	class UEnemyBehaviorTreeComponent* BehaviorTreeComponent;
+
+	//typed access to the blackboard keys the enemy writes
+	FEnemyBlackboard EnemyBlackboard;
 
 public:
 	FORCEINLINE UBlackboardComponent* GetEnemyBlackboardComponent() const { return  BlackboardComponent; }
+
+	FORCEINLINE FEnemyBlackboard& GetEnemyBlackboard() { return EnemyBlackboard; }
 };
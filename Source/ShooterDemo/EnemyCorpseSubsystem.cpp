@@ -0,0 +1,82 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemyCorpseSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterDemo.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Corpses"), STAT_Corpses, STATGROUP_ShooterDemo);
+
+UEnemyCorpseSubsystem::UEnemyCorpseSubsystem() :
+	MaxCorpses(16)
+{
+
+}
+
+bool UEnemyCorpseSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	if (!Super::ShouldCreateSubsystem(Outer)) {
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UEnemyCorpseSubsystem::Deinitialize() {
+	GetWorld()->GetTimerManager().ClearTimer(TrimCorpsesTimer);
+	Corpses.Empty();
+	Super::Deinitialize();
+}
+
+void UEnemyCorpseSubsystem::RemoveStaleCorpses() {
+	Corpses.RemoveAll([](const TWeakObjectPtr<AEnemy>& Corpse) {
+		return !Corpse.IsValid() || !Corpse->IsDying();
+	});
+}
+
+void UEnemyCorpseSubsystem::RegisterCorpse(AEnemy* Enemy) {
+	if (!Enemy) {
+		return;
+	}
+
+	RemoveStaleCorpses();
+	Corpses.AddUnique(Enemy);
+	SET_DWORD_STAT(STAT_Corpses, Corpses.Num());
+
+	//the enemy registering may be the oldest corpse, and is still inside Die
+	if (Corpses.Num() > MaxCorpses && !TrimCorpsesTimer.IsValid()) {
+		TrimCorpsesTimer = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UEnemyCorpseSubsystem::TrimCorpses);
+	}
+}
+
+void UEnemyCorpseSubsystem::TrimCorpses() {
+	TrimCorpsesTimer.Invalidate();
+	RemoveStaleCorpses();
+
+	while (Corpses.Num() > MaxCorpses) {
+		AEnemy* Oldest = Corpses[0].Get();
+		Corpses.RemoveAt(0, 1, false);
+		Oldest->DestroyEnemy();
+	}
+
+	SET_DWORD_STAT(STAT_Corpses, Corpses.Num());
+}
+
+bool UEnemyCorpseSubsystem::RecycleOldestCorpse(TSubclassOf<AEnemy> EnemyClass) {
+	RemoveStaleCorpses();
+
+	const int32 Index{Corpses.IndexOfByPredicate([EnemyClass](const TWeakObjectPtr<AEnemy>& Corpse) {
+		return Corpse->GetClass() == EnemyClass;
+	})};
+	if (Index == INDEX_NONE) {
+		return false;
+	}
+
+	AEnemy* Corpse = Corpses[Index].Get();
+	Corpses.RemoveAt(Index, 1, false);
+	Corpse->DestroyEnemy();
+
+	SET_DWORD_STAT(STAT_Corpses, Corpses.Num());
+	return true;
+}
@@ -0,0 +1,48 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyCorpseSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Caps the number of dead enemies lying around. Past the budget the oldest corpse is
+ * released to its pool (or destroyed) before its death timer runs out
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UEnemyCorpseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyCorpseSubsystem();
+
+	//only created for game and PIE worlds
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	//called when an enemy starts dying, corpses past the budget are released on the next tick
+	void RegisterCorpse(AEnemy* Enemy);
+
+	//releases the oldest corpse of the class early, false if there is none
+	bool RecycleOldestCorpse(TSubclassOf<AEnemy> EnemyClass);
+
+private:
+	//drops destroyed enemies and ones reused from the pool
+	void RemoveStaleCorpses();
+
+	//releases the oldest corpses past the budget; deferred so it never runs inside an enemy's Die
+	void TrimCorpses();
+
+	//oldest first
+	TArray<TWeakObjectPtr<AEnemy>> Corpses;
+
+	FTimerHandle TrimCorpsesTimer;
+
+	UPROPERTY(Config)
+	int32 MaxCorpses;
+};
@@ -0,0 +1,263 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemyCrowdSubsystem.h"
+
+#include "AIController.h"
+#include "Enemy.h"
+#include "ShooterDemo.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Navigation/PathFollowingComponent.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Crowd Agents"), STAT_CrowdAgents, STATGROUP_ShooterDemo);
+
+UEnemyCrowdSubsystem::UEnemyCrowdSubsystem() :
+	FidelityRadius(3000.f),
+	FidelityHysteresis(300.f),
+	MaxAcceleration(2048.f),
+	SeparationRadius(120.f),
+	SeparationStrength(300.f),
+	AcceptanceRadius(50.f),
+	RotationRate(360.f)
+{
+
+}
+
+void UEnemyCrowdSubsystem::Deinitialize() {
+	for (int32 i = Agents.Num() - 1; i >= 0; i--) {
+		RemoveAgentAt(i);
+	}
+	SpatialHash.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UEnemyCrowdSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyCrowdSubsystem::RegisterEnemy(AEnemy* Enemy) {
+	if (!Enemy || Agents.Contains(Enemy)) {
+		return;
+	}
+
+	Agents.Add(Enemy);
+	Positions.Add(Enemy->GetActorLocation());
+	Velocities.Add(FVector::ZeroVector);
+	MaxSpeeds.Add(Enemy->GetCharacterMovement()->GetMaxSpeed());
+	InCrowd.Add(false);
+	Corridors.AddZeroed(MaxCorridorPoints);
+	CorridorLengths.Add(0);
+}
+
+void UEnemyCrowdSubsystem::UnregisterEnemy(AEnemy* Enemy) {
+	const int32 Index{Agents.IndexOfByKey(Enemy)};
+	if (Index != INDEX_NONE) {
+		RemoveAgentAt(Index);
+	}
+}
+
+void UEnemyCrowdSubsystem::RemoveAgentAt(int32 Index) {
+	//never leave an enemy without a movement component ticking
+	SetCrowdMode(Index, false);
+
+	Agents.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	MaxSpeeds.RemoveAtSwap(Index, 1, false);
+	InCrowd.RemoveAtSwap(Index, 1, false);
+	CorridorLengths.RemoveAtSwap(Index, 1, false);
+
+	//move the last agent's corridor block into the freed one
+	const int32 LastBlock{Agents.Num() * MaxCorridorPoints};
+	if (Index * MaxCorridorPoints != LastBlock) {
+		for (int32 k = 0; k < MaxCorridorPoints; k++) {
+			Corridors[Index * MaxCorridorPoints + k] = Corridors[LastBlock + k];
+		}
+	}
+	Corridors.RemoveAt(LastBlock, MaxCorridorPoints, false);
+}
+
+FIntPoint UEnemyCrowdSubsystem::GetHashCell(const FVector& Location) const {
+	return FIntPoint(FMath::FloorToInt(Location.X / SeparationRadius), FMath::FloorToInt(Location.Y / SeparationRadius));
+}
+
+void UEnemyCrowdSubsystem::SetCrowdMode(int32 Index, bool bInCrowd) {
+	if (InCrowd[Index] == bInCrowd) {
+		return;
+	}
+	InCrowd[Index] = bInCrowd;
+
+	AEnemy* Enemy = Agents[Index].Get();
+	if (!Enemy) {
+		return;
+	}
+
+	UCharacterMovementComponent* Movement = Enemy->GetCharacterMovement();
+	if (bInCrowd) {
+		Positions[Index] = Enemy->GetActorLocation();
+		Velocities[Index] = Movement->Velocity;
+		MaxSpeeds[Index] = Movement->GetMaxSpeed();
+		Movement->SetComponentTickEnabled(false);
+	} else {
+		//carry the crowd velocity over and let the next tick find the floor
+		Movement->Velocity = Velocities[Index];
+		Movement->bForceNextFloorCheck = true;
+		Movement->SetComponentTickEnabled(true);
+	}
+}
+
+void UEnemyCrowdSubsystem::Tick(float DeltaTime) {
+	if (Agents.Num() == 0 || DeltaTime <= 0.f) {
+		return;
+	}
+
+	GatherAgents();
+	SimulateCrowd(DeltaTime);
+	WriteBack(DeltaTime);
+}
+
+void UEnemyCrowdSubsystem::GatherAgents() {
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		const APawn* PlayerPawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (PlayerPawn) {
+			PlayerLocations.Add(PlayerPawn->GetActorLocation());
+		}
+	}
+
+	const float EnterRadiusSquared{FMath::Square(FidelityRadius)};
+	const float LeaveRadiusSquared{FMath::Square(FidelityRadius + FidelityHysteresis)};
+
+	int32 NumInCrowd{0};
+	for (int32 i = Agents.Num() - 1; i >= 0; i--) {
+		AEnemy* Enemy = Agents[i].Get();
+		if (!Enemy) {
+			RemoveAgentAt(i);
+			continue;
+		}
+
+		const FVector Location{InCrowd[i] ? Positions[i] : Enemy->GetActorLocation()};
+		float DistanceSquared{TNumericLimits<float>::Max()};
+		for (const FVector& PlayerLocation : PlayerLocations) {
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(PlayerLocation, Location));
+		}
+
+		//only walking, living enemies without a player nearby are simulated cheaply
+		const UCharacterMovementComponent* Movement = Enemy->GetCharacterMovement();
+		const bool bCanCrowd{!Enemy->IsDying() && PlayerLocations.Num() > 0 &&
+			(InCrowd[i] || Movement->MovementMode == MOVE_Walking)};
+		const bool bWantsCrowd{bCanCrowd && DistanceSquared > (InCrowd[i] ? EnterRadiusSquared : LeaveRadiusSquared)};
+		SetCrowdMode(i, bWantsCrowd);
+
+		if (!InCrowd[i]) {
+			//still an obstacle for crowd agents around it
+			Positions[i] = Enemy->GetActorLocation();
+			Velocities[i] = Movement->Velocity;
+			CorridorLengths[i] = 0;
+			continue;
+		}
+		NumInCrowd++;
+
+		//the path following component keeps advancing along the path from the written back location
+		int32 CorridorLength{0};
+		const AAIController* Controller = Cast<AAIController>(Enemy->GetController());
+		const UPathFollowingComponent* PathFollowing = Controller ? Controller->GetPathFollowingComponent() : nullptr;
+		if (PathFollowing && PathFollowing->GetStatus() == EPathFollowingStatus::Moving && PathFollowing->GetPath().IsValid()) {
+			const TArray<FNavPathPoint>& PathPoints = PathFollowing->GetPath()->GetPathPoints();
+			const float HalfHeight{Enemy->GetDefaultHalfHeight()};
+			for (int32 p = PathFollowing->GetNextPathIndex(); p < PathPoints.Num() && CorridorLength < MaxCorridorPoints; p++) {
+				//path points are on the navmesh, agents are centred on their capsule
+				Corridors[i * MaxCorridorPoints + CorridorLength] = PathPoints[p].Location + FVector(0.f, 0.f, HalfHeight);
+				CorridorLength++;
+			}
+		}
+		CorridorLengths[i] = CorridorLength;
+	}
+
+	SET_DWORD_STAT(STAT_CrowdAgents, NumInCrowd);
+}
+
+void UEnemyCrowdSubsystem::SimulateCrowd(float DeltaTime) {
+	const int32 NumAgents{Agents.Num()};
+
+	for (auto& CellPair : SpatialHash) {
+		CellPair.Value.Reset();
+	}
+	for (int32 i = 0; i < NumAgents; i++) {
+		SpatialHash.FindOrAdd(GetHashCell(Positions[i])).Add(i);
+	}
+
+	const float SeparationRadiusSquared{FMath::Square(SeparationRadius)};
+	const float AcceptanceRadiusSquared{FMath::Square(AcceptanceRadius)};
+	const float MaxDeltaVelocity{MaxAcceleration * DeltaTime};
+
+	for (int32 i = 0; i < NumAgents; i++) {
+		if (!InCrowd[i]) {
+			continue;
+		}
+
+		const FVector Position{Positions[i]};
+
+		//steer to the first corridor point not yet reached
+		FVector DesiredVelocity{FVector::ZeroVector};
+		const FVector* Corridor = &Corridors[i * MaxCorridorPoints];
+		for (int32 p = 0; p < CorridorLengths[i]; p++) {
+			const FVector ToPoint{Corridor[p] - Position};
+			const bool bLastPoint{p == CorridorLengths[i] - 1};
+			if (bLastPoint || ToPoint.SizeSquared2D() > AcceptanceRadiusSquared) {
+				//slow down into the end of the path
+				DesiredVelocity = bLastPoint ? ToPoint.GetClampedToMaxSize(MaxSpeeds[i]) : ToPoint.GetSafeNormal() * MaxSpeeds[i];
+				break;
+			}
+		}
+
+		//separation from neighbours in the surrounding cells, horizontal only
+		FVector Separation{FVector::ZeroVector};
+		const FIntPoint Cell{GetHashCell(Position)};
+		for (int32 X = -1; X <= 1; X++) {
+			for (int32 Y = -1; Y <= 1; Y++) {
+				const TArray<int32>* CellAgents = SpatialHash.Find(Cell + FIntPoint(X, Y));
+				if (!CellAgents) {
+					continue;
+				}
+				for (const int32 Other : *CellAgents) {
+					const FVector Away{(Position - Positions[Other]) * FVector(1.f, 1.f, 0.f)};
+					const float DistanceSquared{Away.SizeSquared()};
+					if (Other == i || DistanceSquared >= SeparationRadiusSquared || DistanceSquared < KINDA_SMALL_NUMBER) {
+						continue;
+					}
+					const float Distance{FMath::Sqrt(DistanceSquared)};
+					Separation += Away / Distance * (1.f - Distance / SeparationRadius);
+				}
+			}
+		}
+		DesiredVelocity += Separation * SeparationStrength;
+
+		//acceleration limited change towards the desired velocity
+		const FVector DeltaVelocity{(DesiredVelocity - Velocities[i]).GetClampedToMaxSize(MaxDeltaVelocity)};
+		Velocities[i] = (Velocities[i] + DeltaVelocity).GetClampedToMaxSize(MaxSpeeds[i]);
+		Positions[i] += Velocities[i] * DeltaTime;
+	}
+}
+
+void UEnemyCrowdSubsystem::WriteBack(float DeltaTime) {
+	const float MaxYawDelta{RotationRate * DeltaTime};
+
+	for (int32 i = 0; i < Agents.Num(); i++) {
+		if (!InCrowd[i]) {
+			continue;
+		}
+
+		AEnemy* Enemy = Agents[i].Get();
+		FRotator Rotation{Enemy->GetActorRotation()};
+		if (Velocities[i].SizeSquared2D() > KINDA_SMALL_NUMBER) {
+			const float TargetYaw{Velocities[i].Rotation().Yaw};
+			Rotation.Yaw += FMath::Clamp(FMath::FindDeltaAngleDegrees(Rotation.Yaw, TargetYaw), -MaxYawDelta, MaxYawDelta);
+		}
+
+		Enemy->SetActorLocationAndRotation(Positions[i], Rotation);
+		//the anim blueprint reads speed from the movement component
+		Enemy->GetCharacterMovement()->Velocity = Velocities[i];
+	}
+}
@@ -0,0 +1,91 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "EnemyCrowdSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Cheap movement for enemies far from every player. Their position, velocity and the next
+ * few points of their path are kept in packed arrays and steered with separation from a
+ * spatial hash; only the actor transform and velocity are written back. Close enemies (or
+ * any that get close) hand over to CharacterMovement with their current velocity
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UEnemyCrowdSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyCrowdSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+private:
+	//path points copied per agent
+	static constexpr int32 MaxCorridorPoints{4};
+
+	//picks crowd or character movement for each agent and reads their state from the actors
+	void GatherAgents();
+
+	//steering and separation over the packed arrays
+	void SimulateCrowd(float DeltaTime);
+
+	//moves the actors of crowd agents to their simulated positions
+	void WriteBack(float DeltaTime);
+
+	void SetCrowdMode(int32 Index, bool bInCrowd);
+
+	void RemoveAgentAt(int32 Index);
+
+	FIntPoint GetHashCell(const FVector& Location) const;
+
+	//packed agent state, one entry per registered enemy
+	TArray<TWeakObjectPtr<AEnemy>> Agents;
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> MaxSpeeds;
+	TArray<bool> InCrowd;
+
+	//MaxCorridorPoints entries per agent, starting at the next path point
+	TArray<FVector> Corridors;
+	TArray<int32> CorridorLengths;
+
+	//agent indices by cell for separation
+	TMap<FIntPoint, TArray<int32>> SpatialHash;
+
+	//enemies further than this from every player use crowd movement
+	UPROPERTY(Config)
+	float FidelityRadius;
+
+	//extra distance before switching back to crowd, avoids flipping at the edge
+	UPROPERTY(Config)
+	float FidelityHysteresis;
+
+	UPROPERTY(Config)
+	float MaxAcceleration;
+
+	//agents closer than this push each other apart
+	UPROPERTY(Config)
+	float SeparationRadius;
+
+	UPROPERTY(Config)
+	float SeparationStrength;
+
+	//distance at which a path point counts as reached
+	UPROPERTY(Config)
+	float AcceptanceRadius;
+
+	//degrees per second agents turn towards their velocity
+	UPROPERTY(Config)
+	float RotationRate;
+};
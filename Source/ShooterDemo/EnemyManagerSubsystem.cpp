@@ -0,0 +1,136 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemyManagerSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterDemo.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Managed Enemies"), STAT_ManagedEnemies, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy State Transitions"), STAT_EnemyStateTransitions, STATGROUP_ShooterDemo);
+
+UEnemyManagerSubsystem::UEnemyManagerSubsystem() :
+	MinParallelEnemies(64)
+{
+
+}
+
+void UEnemyManagerSubsystem::Deinitialize() {
+	for (int32 i = Enemies.Num() - 1; i >= 0; i--) {
+		RemoveEnemyAt(i);
+	}
+	Super::Deinitialize();
+}
+
+TStatId UEnemyManagerSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyManagerSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyManagerSubsystem::RegisterEnemy(AEnemy* Enemy) {
+	if (!Enemy || Enemy->EnemyStateIndex != INDEX_NONE) {
+		return;
+	}
+
+	EEnemyStateFlags State{EEnemyStateFlags::None};
+	if (Enemy->bCanAttack) {
+		State |= EEnemyStateFlags::CanAttack;
+	}
+	if (Enemy->bCanHitReact) {
+		State |= EEnemyStateFlags::CanHitReact;
+	}
+
+	Enemy->EnemyStateIndex = Enemies.Add(Enemy);
+	States.Add(State);
+	HitReactCooldowns.Add(0.f);
+	AttackCooldowns.Add(0.f);
+}
+
+void UEnemyManagerSubsystem::UnregisterEnemy(AEnemy* Enemy) {
+	if (Enemy && Enemies.IsValidIndex(Enemy->EnemyStateIndex) && Enemies[Enemy->EnemyStateIndex] == Enemy) {
+		RemoveEnemyAt(Enemy->EnemyStateIndex);
+	}
+}
+
+void UEnemyManagerSubsystem::RemoveEnemyAt(int32 Index) {
+	AEnemy* Enemy = Enemies[Index].Get();
+	if (Enemy) {
+		Enemy->EnemyStateIndex = INDEX_NONE;
+	}
+
+	Enemies.RemoveAtSwap(Index, 1, false);
+	States.RemoveAtSwap(Index, 1, false);
+	HitReactCooldowns.RemoveAtSwap(Index, 1, false);
+	AttackCooldowns.RemoveAtSwap(Index, 1, false);
+
+	//the last enemy was moved into the freed slot
+	AEnemy* MovedEnemy = Enemies.IsValidIndex(Index) ? Enemies[Index].Get() : nullptr;
+	if (MovedEnemy) {
+		MovedEnemy->EnemyStateIndex = Index;
+	}
+}
+
+void UEnemyManagerSubsystem::StartHitReactCooldown(const AEnemy* Enemy, float Cooldown) {
+	const int32 Index{Enemy->EnemyStateIndex};
+	if (States.IsValidIndex(Index)) {
+		EnumRemoveFlags(States[Index], EEnemyStateFlags::CanHitReact);
+		HitReactCooldowns[Index] = Cooldown;
+	}
+}
+
+void UEnemyManagerSubsystem::StartAttackCooldown(const AEnemy* Enemy, float Cooldown) {
+	const int32 Index{Enemy->EnemyStateIndex};
+	if (States.IsValidIndex(Index)) {
+		EnumRemoveFlags(States[Index], EEnemyStateFlags::CanAttack);
+		AttackCooldowns[Index] = Cooldown;
+	}
+}
+
+void UEnemyManagerSubsystem::Tick(float DeltaTime) {
+	const int32 NumEnemies{Enemies.Num()};
+	SET_DWORD_STAT(STAT_ManagedEnemies, NumEnemies);
+	if (NumEnemies == 0) {
+		return;
+	}
+
+	//every index is written by exactly one worker, actors aren't touched here
+	Transitions.SetNumUninitialized(NumEnemies, false);
+	ParallelFor(NumEnemies, [this, DeltaTime](int32 i) {
+		EEnemyStateFlags Transition{EEnemyStateFlags::None};
+
+		if (HitReactCooldowns[i] > 0.f) {
+			HitReactCooldowns[i] -= DeltaTime;
+			if (HitReactCooldowns[i] <= 0.f) {
+				Transition |= EEnemyStateFlags::CanHitReact;
+			}
+		}
+
+		if (AttackCooldowns[i] > 0.f) {
+			AttackCooldowns[i] -= DeltaTime;
+			if (AttackCooldowns[i] <= 0.f) {
+				Transition |= EEnemyStateFlags::CanAttack;
+			}
+		}
+
+		States[i] |= Transition;
+		Transitions[i] = Transition;
+	}, NumEnemies < MinParallelEnemies ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	//game thread: only enemies whose state changed
+	int32 NumTransitions{0};
+	for (int32 i = NumEnemies - 1; i >= 0; i--) {
+		if (Transitions[i] == EEnemyStateFlags::None) {
+			continue;
+		}
+
+		AEnemy* Enemy = Enemies[i].Get();
+		if (!Enemy) {
+			RemoveEnemyAt(i);
+			continue;
+		}
+		Enemy->OnStateTransition(Transitions[i]);
+		NumTransitions++;
+	}
+
+	SET_DWORD_STAT(STAT_EnemyStateTransitions, NumTransitions);
+}
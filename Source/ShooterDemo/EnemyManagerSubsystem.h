@@ -0,0 +1,61 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "EnemyManagerSubsystem.generated.h"
+
+class AEnemy;
+
+//combat state bits of one enemy
+enum class EEnemyStateFlags : uint8
+{
+	None = 0,
+	CanAttack = 1 << 0,
+	CanHitReact = 1 << 1
+};
+ENUM_CLASS_FLAGS(EEnemyStateFlags);
+
+/**
+ * Combat state and cooldowns of every active enemy in packed arrays. Cooldowns are counted
+ * down in parallel once per frame and only enemies whose state changed are called back
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UEnemyManagerSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyManagerSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	//clears CanHitReact until the cooldown runs out
+	void StartHitReactCooldown(const AEnemy* Enemy, float Cooldown);
+
+	//clears CanAttack until the cooldown runs out
+	void StartAttackCooldown(const AEnemy* Enemy, float Cooldown);
+
+private:
+	void RemoveEnemyAt(int32 Index);
+
+	//packed state, one entry per registered enemy
+	TArray<TWeakObjectPtr<AEnemy>> Enemies;
+	TArray<EEnemyStateFlags> States;
+	TArray<float> HitReactCooldowns;
+	TArray<float> AttackCooldowns;
+
+	//bits that became set this frame, written by the parallel update
+	TArray<EEnemyStateFlags> Transitions;
+
+	//fewer enemies than this are updated on the game thread
+	UPROPERTY(Config)
+	int32 MinParallelEnemies;
+};
@@ -0,0 +1,216 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemyPerceptionSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterDemo.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending Sight Traces"), STAT_PendingSightTraces, STATGROUP_ShooterDemo);
+
+UEnemyPerceptionSubsystem::UEnemyPerceptionSubsystem() :
+	NextTraceId(0),
+	EnemyCursor(0),
+	CellSize(2000.f),
+	MaxEnemiesPerTick(32),
+	MaxTracesPerTick(8)
+{
+
+}
+
+void UEnemyPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	LineOfSightDelegate.BindUObject(this, &UEnemyPerceptionSubsystem::OnLineOfSightTraceDone);
+}
+
+void UEnemyPerceptionSubsystem::Deinitialize() {
+	LineOfSightDelegate.Unbind();
+	Enemies.Empty();
+	Targets.Empty();
+	TargetGrid.Empty();
+	PendingSights.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UEnemyPerceptionSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyPerceptionSubsystem::RegisterEnemy(AEnemy* Enemy) {
+	if (!Enemy) {
+		return;
+	}
+
+	const bool bRegistered{Enemies.ContainsByPredicate([Enemy](const FSensingEnemy& SensingEnemy) {
+		return SensingEnemy.Enemy.Get() == Enemy;
+	})};
+	if (!bRegistered) {
+		FSensingEnemy SensingEnemy;
+		SensingEnemy.Enemy = Enemy;
+		Enemies.Add(SensingEnemy);
+	}
+}
+
+void UEnemyPerceptionSubsystem::UnregisterEnemy(AEnemy* Enemy) {
+	const int32 Index{Enemies.IndexOfByPredicate([Enemy](const FSensingEnemy& SensingEnemy) {
+		return SensingEnemy.Enemy.Get() == Enemy;
+	})};
+	if (Index != INDEX_NONE) {
+		Enemies.RemoveAtSwap(Index);
+	}
+}
+
+void UEnemyPerceptionSubsystem::RegisterTarget(AActor* Target) {
+	if (Target) {
+		Targets.AddUnique(Target);
+	}
+}
+
+void UEnemyPerceptionSubsystem::UnregisterTarget(AActor* Target) {
+	Targets.RemoveSwap(Target);
+}
+
+FIntPoint UEnemyPerceptionSubsystem::GetGridCell(const FVector& Location) const {
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void UEnemyPerceptionSubsystem::Tick(float DeltaTime) {
+	RebuildTargetGrid();
+
+	if (TargetGrid.Num() > 0 && Enemies.Num() > 0) {
+		int32 TracesStarted{0};
+		const int32 NumToSense{FMath::Min(MaxEnemiesPerTick, Enemies.Num())};
+		for (int32 i = 0; i < NumToSense && TracesStarted < MaxTracesPerTick; i++) {
+			if (EnemyCursor >= Enemies.Num()) {
+				EnemyCursor = 0;
+			}
+
+			FSensingEnemy& SensingEnemy = Enemies[EnemyCursor];
+			if (!SensingEnemy.Enemy.IsValid()) {
+				//swap removal moves an unvisited enemy into the cursor slot
+				Enemies.RemoveAtSwap(EnemyCursor);
+				continue;
+			}
+
+			const bool bWasPending{SensingEnemy.bTracePending};
+			SenseEnemy(SensingEnemy);
+			if (!bWasPending && SensingEnemy.bTracePending) {
+				TracesStarted++;
+			}
+			EnemyCursor++;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PendingSightTraces, PendingSights.Num());
+}
+
+void UEnemyPerceptionSubsystem::RebuildTargetGrid() {
+	for (auto& CellPair : TargetGrid) {
+		CellPair.Value.Reset();
+	}
+
+	Targets.RemoveAllSwap([](const TWeakObjectPtr<AActor>& Target) {
+		return !Target.IsValid();
+	});
+	for (int32 i = 0; i < Targets.Num(); i++) {
+		TargetGrid.FindOrAdd(GetGridCell(Targets[i]->GetActorLocation())).Add(i);
+	}
+
+	//drop cells nobody is in anymore
+	for (auto It = TargetGrid.CreateIterator(); It; ++It) {
+		if (It.Value().Num() == 0) {
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UEnemyPerceptionSubsystem::SenseEnemy(FSensingEnemy& SensingEnemy) {
+	AEnemy* Enemy = SensingEnemy.Enemy.Get();
+	if (SensingEnemy.bTracePending || !Enemy->CanSenseTargets()) {
+		return;
+	}
+
+	const FVector EyeLocation{Enemy->GetPawnViewLocation()};
+	const FVector Forward{Enemy->GetActorForwardVector()};
+	const float SightRadius{Enemy->GetSightRadius()};
+	const float SightRadiusSquared{FMath::Square(SightRadius)};
+	const float ProximityRadiusSquared{FMath::Square(Enemy->GetProximityRadius())};
+	const float CosHalfAngle{FMath::Cos(FMath::DegreesToRadians(Enemy->GetPeripheralVisionAngle()))};
+
+	//closest target inside range and view cone
+	AActor* BestTarget{nullptr};
+	float BestDistanceSquared{SightRadiusSquared};
+
+	const FIntPoint MinCell{GetGridCell(EyeLocation - FVector(SightRadius))};
+	const FIntPoint MaxCell{GetGridCell(EyeLocation + FVector(SightRadius))};
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++) {
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++) {
+			const TArray<int32>* CellTargets = TargetGrid.Find(FIntPoint(X, Y));
+			if (!CellTargets) {
+				continue;
+			}
+
+			for (const int32 TargetIndex : *CellTargets) {
+				AActor* Target = Targets[TargetIndex].Get();
+				const FVector ToTarget{Target->GetActorLocation() - EyeLocation};
+				const float DistanceSquared{ToTarget.SizeSquared()};
+				if (DistanceSquared > BestDistanceSquared) {
+					continue;
+				}
+
+				//anything very close is noticed regardless of facing
+				if (DistanceSquared > ProximityRadiusSquared &&
+					FVector::DotProduct(ToTarget.GetSafeNormal(), Forward) < CosHalfAngle) {
+					continue;
+				}
+
+				BestTarget = Target;
+				BestDistanceSquared = DistanceSquared;
+			}
+		}
+	}
+
+	if (!BestTarget) {
+		return;
+	}
+
+	//only static geometry blocks sight; other enemies don't
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(EnemyLineOfSight), false, Enemy);
+	QueryParams.AddIgnoredActor(BestTarget);
+
+	const uint32 TraceId{NextTraceId++};
+	GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, EyeLocation, BestTarget->GetActorLocation(),
+		FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams, &LineOfSightDelegate, TraceId);
+
+	FPendingSight PendingSight;
+	PendingSight.Enemy = Enemy;
+	PendingSight.Target = BestTarget;
+	PendingSights.Add(TraceId, PendingSight);
+	SensingEnemy.bTracePending = true;
+}
+
+void UEnemyPerceptionSubsystem::OnLineOfSightTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum) {
+	FPendingSight PendingSight;
+	if (!PendingSights.RemoveAndCopyValue(TraceDatum.UserData, PendingSight)) {
+		return;
+	}
+
+	AEnemy* Enemy = PendingSight.Enemy.Get();
+	if (!Enemy) {
+		return;
+	}
+
+	FSensingEnemy* SensingEnemy = Enemies.FindByPredicate([Enemy](const FSensingEnemy& Entry) {
+		return Entry.Enemy.Get() == Enemy;
+	});
+	if (SensingEnemy) {
+		SensingEnemy->bTracePending = false;
+	}
+
+	const bool bBlocked{TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit};
+	AActor* Target = PendingSight.Target.Get();
+	if (!bBlocked && Target && Enemy->CanSenseTargets()) {
+		Enemy->SetPerceivedTarget(Target);
+	}
+}
@@ -0,0 +1,87 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "WorldCollision.h"
+#include "EnemyPerceptionSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Sight for all enemies: targets are kept in a grid, enemies are evaluated a batch per frame
+ * (range, view cone) and candidates confirmed with a budgeted async line of sight trace
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UEnemyPerceptionSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyPerceptionSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	//actors enemies can see and aggro on
+	void RegisterTarget(AActor* Target);
+	void UnregisterTarget(AActor* Target);
+
+private:
+	struct FSensingEnemy {
+		TWeakObjectPtr<AEnemy> Enemy;
+		//a line of sight trace is in flight for this enemy
+		bool bTracePending{false};
+	};
+
+	struct FPendingSight {
+		TWeakObjectPtr<AEnemy> Enemy;
+		TWeakObjectPtr<AActor> Target;
+	};
+
+	//puts every target into its grid cell
+	void RebuildTargetGrid();
+
+	//range and view cone test against nearby targets, queues a trace for the closest candidate
+	void SenseEnemy(FSensingEnemy& SensingEnemy);
+
+	void OnLineOfSightTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	FIntPoint GetGridCell(const FVector& Location) const;
+
+	TArray<FSensingEnemy> Enemies;
+
+	TArray<TWeakObjectPtr<AActor>> Targets;
+
+	//target indices by grid cell, rebuilt every frame
+	TMap<FIntPoint, TArray<int32>> TargetGrid;
+
+	//in flight traces by their user data id
+	TMap<uint32, FPendingSight> PendingSights;
+
+	FTraceDelegate LineOfSightDelegate;
+
+	uint32 NextTraceId;
+
+	//next enemy to evaluate, wraps around
+	int32 EnemyCursor;
+
+	//size of the target grid cells
+	UPROPERTY(Config)
+	float CellSize;
+
+	//enemies evaluated per frame
+	UPROPERTY(Config)
+	int32 MaxEnemiesPerTick;
+
+	//line of sight traces started per frame
+	UPROPERTY(Config)
+	int32 MaxTracesPerTick;
+};
@@ -0,0 +1,149 @@
+// Andrei Nikitin 2022
+
+
+#include "EnemySignificanceSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterDemo.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies"), STAT_Enemies, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Full Fidelity Enemies"), STAT_FullFidelityEnemies, STATGROUP_ShooterDemo);
+
+UEnemySignificanceSubsystem::UEnemySignificanceSubsystem() :
+	TimeUntilUpdate(0.f),
+	UpdateInterval(0.25f),
+	NumFullFidelity(12),
+	OffscreenDistanceScale(2.f),
+	RecentlyRenderedTime(0.5f)
+{
+	FEnemySignificanceTier FullTier;
+	FullTier.MaxDistance = 2500.f;
+	Tiers.Add(FullTier);
+
+	FEnemySignificanceTier MediumTier;
+	MediumTier.MaxDistance = 5000.f;
+	MediumTier.ActorTickInterval = 0.1f;
+	MediumTier.MovementTickInterval = 0.033f;
+	MediumTier.AnimTickInterval = 0.033f;
+	MediumTier.BehaviorTreeTickInterval = 0.1f;
+	MediumTier.AnimationSignificance = 0.6f;
+	Tiers.Add(MediumTier);
+
+	FEnemySignificanceTier LowTier;
+	LowTier.MaxDistance = 10000.f;
+	LowTier.ActorTickInterval = 0.25f;
+	LowTier.MovementTickInterval = 0.1f;
+	LowTier.AnimTickInterval = 0.1f;
+	LowTier.BehaviorTreeTickInterval = 0.25f;
+	LowTier.AnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	LowTier.AnimationSignificance = 0.3f;
+	Tiers.Add(LowTier);
+
+	FEnemySignificanceTier DormantTier;
+	DormantTier.ActorTickInterval = 1.f;
+	DormantTier.MovementTickInterval = 0.25f;
+	DormantTier.AnimTickInterval = 0.25f;
+	DormantTier.BehaviorTreeTickInterval = 0.5f;
+	DormantTier.AnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	DormantTier.AnimationSignificance = 0.1f;
+	DormantTier.bShareAnimation = true;
+	Tiers.Add(DormantTier);
+}
+
+void UEnemySignificanceSubsystem::Deinitialize() {
+	Enemies.Empty();
+	RankedEnemies.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy) {
+	if (Enemy) {
+		Enemies.AddUnique(Enemy);
+	}
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy) {
+	Enemies.RemoveSwap(Enemy);
+}
+
+int32 UEnemySignificanceSubsystem::GetTierForDistance(float Distance) const {
+	for (int32 i = 0; i < Tiers.Num() - 1; i++) {
+		if (Distance <= Tiers[i].MaxDistance) {
+			return i;
+		}
+	}
+	return Tiers.Num() - 1;
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime) {
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f || Tiers.Num() == 0) {
+		return;
+	}
+	TimeUntilUpdate = UpdateInterval;
+
+	//view points of every player, split screen included
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController) {
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+	if (ViewLocations.Num() == 0) {
+		return;
+	}
+
+	const float OffscreenScaleSquared{FMath::Square(OffscreenDistanceScale)};
+
+	RankedEnemies.Reset();
+	for (int32 i = Enemies.Num() - 1; i >= 0; i--) {
+		AEnemy* Enemy = Enemies[i].Get();
+		if (!Enemy) {
+			Enemies.RemoveAtSwap(i);
+			continue;
+		}
+
+		const FVector EnemyLocation{Enemy->GetActorLocation()};
+		float DistanceSquared{TNumericLimits<float>::Max()};
+		for (const FVector& ViewLocation : ViewLocations) {
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(ViewLocation, EnemyLocation));
+		}
+		if (!Enemy->WasRecentlyRendered(RecentlyRenderedTime)) {
+			DistanceSquared *= OffscreenScaleSquared;
+		}
+
+		FRankedEnemy RankedEnemy;
+		RankedEnemy.Enemy = Enemy;
+		RankedEnemy.DistanceSquared = DistanceSquared;
+		RankedEnemies.Add(RankedEnemy);
+	}
+
+	RankedEnemies.Sort([](const FRankedEnemy& A, const FRankedEnemy& B) {
+		return A.DistanceSquared < B.DistanceSquared;
+	});
+
+	int32 NumFull{0};
+	for (int32 Rank = 0; Rank < RankedEnemies.Num(); Rank++) {
+		int32 Tier{GetTierForDistance(FMath::Sqrt(RankedEnemies[Rank].DistanceSquared))};
+		//past the nearest few everyone gets at most the second tier
+		if (Tier == 0 && Rank >= NumFullFidelity) {
+			Tier = FMath::Min(1, Tiers.Num() - 1);
+		}
+		if (Tier == 0) {
+			NumFull++;
+		}
+		RankedEnemies[Rank].Enemy->SetSignificanceTier(Tier, Tiers[Tier]);
+	}
+
+	SET_DWORD_STAT(STAT_Enemies, RankedEnemies.Num());
+	SET_DWORD_STAT(STAT_FullFidelityEnemies, NumFull);
+}
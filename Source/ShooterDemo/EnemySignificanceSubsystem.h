@@ -0,0 +1,101 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+//update rates for one level of detail; 0 interval means every frame
+USTRUCT()
+struct FEnemySignificanceTier {
+	GENERATED_BODY()
+
+	//enemies further than this (after the off screen scale) use the next tier
+	UPROPERTY(EditAnywhere)
+	float MaxDistance{0.f};
+
+	UPROPERTY(EditAnywhere)
+	float ActorTickInterval{0.f};
+
+	UPROPERTY(EditAnywhere)
+	float MovementTickInterval{0.f};
+
+	//mesh tick, drives the anim graph update
+	UPROPERTY(EditAnywhere)
+	float AnimTickInterval{0.f};
+
+	UPROPERTY(EditAnywhere)
+	float BehaviorTreeTickInterval{0.f};
+
+	UPROPERTY(EditAnywhere)
+	EVisibilityBasedAnimTickOption AnimTickOption{EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones};
+
+	//priority with the animation budget allocator, which then replaces AnimTickInterval
+	UPROPERTY(EditAnywhere)
+	float AnimationSignificance{1.f};
+
+	//enemies out of combat follow a shared pose from the animation sharing manager
+	UPROPERTY(EditAnywhere)
+	bool bShareAnimation{false};
+};
+
+/**
+ * Ranks enemies by distance and visibility to the players and assigns each one a tier
+ * that sets its actor, movement, animation and behaviour tree update rates
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UEnemySignificanceSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemySignificanceSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+private:
+	struct FRankedEnemy {
+		AEnemy* Enemy{nullptr};
+		float DistanceSquared{0.f};
+	};
+
+	//distance based tier, capped so only the nearest enemies get tier 0
+	int32 GetTierForDistance(float Distance) const;
+
+	TArray<TWeakObjectPtr<AEnemy>> Enemies;
+
+	//scratch array reused between updates
+	TArray<FRankedEnemy> RankedEnemies;
+
+	float TimeUntilUpdate;
+
+	//seconds between re-ranking enemies
+	UPROPERTY(Config)
+	float UpdateInterval;
+
+	//how many of the nearest enemies may run at full fidelity
+	UPROPERTY(Config)
+	int32 NumFullFidelity;
+
+	//enemies not rendered recently count as this much further away
+	UPROPERTY(Config)
+	float OffscreenDistanceScale;
+
+	//seconds since last render for an enemy to count as visible
+	UPROPERTY(Config)
+	float RecentlyRenderedTime;
+
+	//tier 0 is full fidelity, the last tier catches everything further away
+	UPROPERTY(Config)
+	TArray<FEnemySignificanceTier> Tiers;
+};
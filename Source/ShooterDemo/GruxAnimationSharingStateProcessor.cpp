@@ -0,0 +1,40 @@
+// Andrei Nikitin 2022
+
+
+#include "GruxAnimationSharingStateProcessor.h"
+
+#include "Enemy.h"
+
+UGruxAnimationSharingStateProcessor::UGruxAnimationSharingStateProcessor() :
+	WalkSpeed(10.f),
+	RunSpeed(300.f)
+{
+
+}
+
+void UGruxAnimationSharingStateProcessor::ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess) {
+	const AEnemy* Enemy = Cast<AEnemy>(InActor);
+	if (!Enemy) {
+		bShouldProcess = false;
+		return;
+	}
+
+	//same lateral speed the anim instance uses
+	FVector Velocity{Enemy->GetVelocity()};
+	Velocity.Z = 0.f;
+	const float Speed{Velocity.Size()};
+
+	EGruxAnimationState State{EGruxAnimationState::EGAS_Idle};
+	if (Speed > RunSpeed) {
+		State = EGruxAnimationState::EGAS_Run;
+	} else if (Speed > WalkSpeed) {
+		State = EGruxAnimationState::EGAS_Walk;
+	}
+
+	OutState = static_cast<int32>(State);
+	bShouldProcess = true;
+}
+
+UEnum* UGruxAnimationSharingStateProcessor::GetAnimationStateEnum_Implementation() {
+	return StaticEnum<EGruxAnimationState>();
+}
@@ -0,0 +1,43 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationSharingTypes.h"
+#include "GruxAnimationSharingStateProcessor.generated.h"
+
+//locomotion states a shared Grux pose can be in
+UENUM(BlueprintType)
+enum class EGruxAnimationState : uint8
+{
+	EGAS_Idle UMETA(DisplayName = "Idle"),
+	EGAS_Walk UMETA(DisplayName = "Walk"),
+	EGAS_Run UMETA(DisplayName = "Run"),
+
+	EGAS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/**
+ * Picks the shared locomotion state of a Grux from its speed; set as the state processor of the
+ * Grux entry in the animation sharing setup
+ */
+UCLASS()
+class SHOOTERDEMO_API UGruxAnimationSharingStateProcessor : public UAnimationSharingStateProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UGruxAnimationSharingStateProcessor();
+
+	virtual void ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess) override;
+	virtual UEnum* GetAnimationStateEnum_Implementation() override;
+
+private:
+	//lateral speed above which a Grux walks
+	UPROPERTY(EditAnywhere, Category = "Animation Sharing", meta = (AllowPrivateAccess = "true"))
+	float WalkSpeed;
+
+	//lateral speed above which a Grux runs
+	UPROPERTY(EditAnywhere, Category = "Animation Sharing", meta = (AllowPrivateAccess = "true"))
+	float RunSpeed;
+};
@@ -0,0 +1,204 @@
+// Andrei Nikitin 2022
+
+
+#include "HitNumberComponent.h"
+
+#include "HitNumberWidget.h"
+#include "SceneView.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+
+UHitNumberComponent::UHitNumberComponent() :
+	HitNumberLifeTime(1.5f),
+	InitialPoolSize(16),
+	MaxHitNumbers(64),
+	NumPooledWidgets(0),
+	bHasViewProjection(false)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	//position numbers after the camera has moved this frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UHitNumberComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (!PlayerController || !PlayerController->IsLocalController() || !HitNumberWidgetClass) {
+		return;
+	}
+
+	for (int32 i = 0; i < InitialPoolSize; i++) {
+		UHitNumberWidget* Widget = AcquireWidget();
+		if (!Widget) {
+			break;
+		}
+		FreeWidgets.Add(Widget);
+	}
+}
+
+void UHitNumberComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	for (const FHitNumber& HitNumber : HitNumbers) {
+		if (HitNumber.Widget) {
+			HitNumber.Widget->RemoveFromParent();
+		}
+	}
+	for (UHitNumberWidget* Widget : FreeWidgets) {
+		if (Widget) {
+			Widget->RemoveFromParent();
+		}
+	}
+	HitNumbers.Empty();
+	FreeWidgets.Empty();
+	NumPooledWidgets = 0;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHitNumberComponent::ShowHitNumber(AActor* HitActor, int32 Damage, const FVector& Location, bool bHeadShot) {
+	//several pellets / bullets on the same actor this frame become one number
+	for (FHitNumber& HitNumber : HitNumbers) {
+		if (HitNumber.bPooled && HitNumber.Frame == GFrameCounter && HitNumber.HitActor.Get() == HitActor) {
+			HitNumber.Damage += Damage;
+			HitNumber.bHeadShot |= bHeadShot;
+			HitNumber.Location = Location;
+			static_cast<UHitNumberWidget*>(HitNumber.Widget)->SetHitNumber(HitNumber.Damage, HitNumber.bHeadShot);
+			return;
+		}
+	}
+
+	UHitNumberWidget* Widget = FreeWidgets.Num() > 0 ? FreeWidgets.Pop(false) : AcquireWidget();
+	if (!Widget) {
+		//pool is at its cap, recycle the oldest number on screen
+		const int32 OldestIndex{HitNumbers.IndexOfByPredicate([](const FHitNumber& HitNumber) { return HitNumber.bPooled; })};
+		if (OldestIndex == INDEX_NONE) {
+			return;
+		}
+		Widget = static_cast<UHitNumberWidget*>(HitNumbers[OldestIndex].Widget);
+		HitNumbers.RemoveAt(OldestIndex);
+	}
+
+	Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	Widget->SetHitNumber(Damage, bHeadShot);
+
+	FHitNumber HitNumber;
+	HitNumber.Widget = Widget;
+	HitNumber.Location = Location;
+	HitNumber.ExpireTime = GetWorld()->GetTimeSeconds() + HitNumberLifeTime;
+	HitNumber.HitActor = HitActor;
+	HitNumber.Frame = GFrameCounter;
+	HitNumber.Damage = Damage;
+	HitNumber.bHeadShot = bHeadShot;
+	HitNumber.bPooled = true;
+	AddHitNumber(HitNumber);
+}
+
+void UHitNumberComponent::AddHitNumberWidget(UUserWidget* Widget, const FVector& Location, float LifeTime) {
+	if (!Widget) {
+		return;
+	}
+
+	FHitNumber HitNumber;
+	HitNumber.Widget = Widget;
+	HitNumber.Location = Location;
+	HitNumber.ExpireTime = GetWorld()->GetTimeSeconds() + LifeTime;
+	HitNumber.Frame = GFrameCounter;
+	AddHitNumber(HitNumber);
+}
+
+void UHitNumberComponent::AddHitNumber(const FHitNumber& HitNumber) {
+	HitNumbers.Add(HitNumber);
+
+	//position only the new number so it doesn't flash at the viewport origin, the tick moves the rest
+	if (bHasViewProjection || UpdateViewProjection()) {
+		PositionHitNumber(HitNumber);
+	}
+	SetComponentTickEnabled(true);
+}
+
+UHitNumberWidget* UHitNumberComponent::AcquireWidget() {
+	if (!HitNumberWidgetClass || NumPooledWidgets >= MaxHitNumbers) {
+		return nullptr;
+	}
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	UHitNumberWidget* Widget = CreateWidget<UHitNumberWidget>(PlayerController, HitNumberWidgetClass);
+	if (!Widget) {
+		return nullptr;
+	}
+
+	Widget->AddToViewport();
+	Widget->SetVisibility(ESlateVisibility::Collapsed);
+	NumPooledWidgets++;
+	return Widget;
+}
+
+void UHitNumberComponent::ReleaseHitNumber(const FHitNumber& HitNumber) {
+	if (!HitNumber.Widget) {
+		return;
+	}
+
+	if (HitNumber.bPooled) {
+		HitNumber.Widget->SetVisibility(ESlateVisibility::Collapsed);
+		FreeWidgets.Add(static_cast<UHitNumberWidget*>(HitNumber.Widget));
+	} else {
+		HitNumber.Widget->RemoveFromParent();
+	}
+}
+
+void UHitNumberComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) {
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const float Now{GetWorld()->GetTimeSeconds()};
+	for (int32 i = HitNumbers.Num() - 1; i >= 0; i--) {
+		if (HitNumbers[i].ExpireTime <= Now) {
+			ReleaseHitNumber(HitNumbers[i]);
+			//keep the order, the oldest number is recycled first
+			HitNumbers.RemoveAt(i, 1, false);
+		}
+	}
+
+	if (HitNumbers.Num() == 0) {
+		//the camera moves while nothing is on screen, don't reuse this view
+		bHasViewProjection = false;
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	if (UpdateViewProjection()) {
+		UpdatePositions();
+	}
+}
+
+bool UHitNumberComponent::UpdateViewProjection() {
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	const ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (!LocalPlayer || !LocalPlayer->ViewportClient) {
+		return false;
+	}
+
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData)) {
+		return false;
+	}
+	ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	ViewRect = ProjectionData.GetConstrainedViewRect();
+	bHasViewProjection = true;
+	return true;
+}
+
+void UHitNumberComponent::PositionHitNumber(const FHitNumber& HitNumber) const {
+	FVector2D ScreenPosition{FVector2D::ZeroVector};
+	if (HitNumber.Widget && FSceneView::ProjectWorldToScreen(HitNumber.Location, ViewRect, ViewProjectionMatrix, ScreenPosition)) {
+		HitNumber.Widget->SetPositionInViewport(ScreenPosition);
+	}
+}
+
+void UHitNumberComponent::UpdatePositions() {
+	//one view projection for every number instead of one per ProjectWorldToScreen call
+	for (const FHitNumber& HitNumber : HitNumbers) {
+		PositionHitNumber(HitNumber);
+	}
+}
@@ -0,0 +1,112 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HitNumberComponent.generated.h"
+
+class UHitNumberWidget;
+
+USTRUCT()
+struct FHitNumber {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UUserWidget* Widget{nullptr};
+
+	//world location the number is anchored to
+	FVector Location{FVector::ZeroVector};
+
+	//world time when the number is removed
+	float ExpireTime{0.f};
+
+	//actor that was hit; numbers on the same actor in the same frame are merged
+	TWeakObjectPtr<AActor> HitActor;
+
+	uint64 Frame{0};
+
+	int32 Damage{0};
+
+	bool bHeadShot{false};
+
+	//false for widgets created by blueprints, those are removed instead of pooled
+	bool bPooled{false};
+};
+
+/**
+ * Owns every hit number of a local player: pooled widgets, one flat array with
+ * expiry times and a single world-to-screen projection pass per frame
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SHOOTERDEMO_API UHitNumberComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHitNumberComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//shows damage at location; hits on the same actor in the same frame are added together
+	void ShowHitNumber(AActor* HitActor, int32 Damage, const FVector& Location, bool bHeadShot);
+
+	//takes over a widget created elsewhere (blueprints) for positioning and removal
+	void AddHitNumberWidget(UUserWidget* Widget, const FVector& Location, float LifeTime);
+
+	//true when a widget class is set and numbers can be pooled
+	FORCEINLINE bool CanShowHitNumbers() const { return HitNumberWidgetClass != nullptr; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	//gets a widget from the pool, creating one while under the cap
+	UHitNumberWidget* AcquireWidget();
+
+	void ReleaseHitNumber(const FHitNumber& HitNumber);
+
+	//reads the local player's view projection for this frame, false without a viewport
+	bool UpdateViewProjection();
+
+	//projects one number with the last view projection
+	void PositionHitNumber(const FHitNumber& HitNumber) const;
+
+	//projects every number to the screen with one view projection matrix
+	void UpdatePositions();
+
+	void AddHitNumber(const FHitNumber& HitNumber);
+
+	//widget class used for pooled hit numbers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hit Numbers", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UHitNumberWidget> HitNumberWidgetClass;
+
+	//time before a hit number is removed from the screen
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hit Numbers", meta = (AllowPrivateAccess = "true"))
+	float HitNumberLifeTime;
+
+	//widgets created up front
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hit Numbers", meta = (AllowPrivateAccess = "true"))
+	int32 InitialPoolSize;
+
+	//max numbers on screen; the oldest is recycled past this
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hit Numbers", meta = (AllowPrivateAccess = "true"))
+	int32 MaxHitNumbers;
+
+	//numbers currently on screen
+	UPROPERTY()
+	TArray<FHitNumber> HitNumbers;
+
+	//hidden widgets ready for reuse
+	UPROPERTY()
+	TArray<UHitNumberWidget*> FreeWidgets;
+
+	//every pooled widget, on screen or not
+	int32 NumPooledWidgets;
+
+	//view projection of the last update, shared by every number
+	FMatrix ViewProjectionMatrix;
+	FIntRect ViewRect;
+	bool bHasViewProjection;
+};
@@ -0,0 +1,5 @@
+// Andrei Nikitin 2022
+
+
+#include "HitNumberWidget.h"
+
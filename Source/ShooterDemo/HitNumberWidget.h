@@ -0,0 +1,21 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HitNumberWidget.generated.h"
+
+/**
+ * Damage number shown where a bullet hit; instances are pooled and reused by UHitNumberComponent
+ */
+UCLASS()
+class SHOOTERDEMO_API UHitNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	//set the text / colour and restart the pop animation; called again when hits are coalesced
+	UFUNCTION(BlueprintImplementableEvent)
+	void SetHitNumber(int32 Damage, bool bHeadShot);
+};
@@ -0,0 +1,137 @@
+// Andrei Nikitin 2022
+
+
+#include "InventoryComponent.h"
+
+#include "Item.h"
+#include "Net/UnrealNetwork.h"
+
+void FInventorySlot::PostReplicatedAdd(const FInventorySlotArray& InArraySerializer) {
+	if (InArraySerializer.Owner) {
+		InArraySerializer.Owner->UpdateSlot(SlotIndex, Item);
+	}
+}
+
+void FInventorySlot::PostReplicatedChange(const FInventorySlotArray& InArraySerializer) {
+	if (InArraySerializer.Owner) {
+		InArraySerializer.Owner->UpdateSlot(SlotIndex, Item);
+	}
+}
+
+UInventoryComponent::UInventoryComponent() :
+	Capacity(6),
+	FreeSlotMask(0)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	bWantsInitializeComponent = true;
+	SetIsReplicatedByDefault(true);
+}
+
+void UInventoryComponent::InitializeComponent() {
+	Super::InitializeComponent();
+
+	Slots.Owner = this;
+	Capacity = FMath::Clamp(Capacity, 1, 32);
+	Items.Init(nullptr, Capacity);
+	Ammo.Init(0, static_cast<int32>(EAmmoType::EAT_MAX));
+	FreeSlotMask = Capacity == 32 ? MAX_uint32 : (1u << Capacity) - 1;
+
+	//clients get the slots from the server
+	const AActor* Owner = GetOwner();
+	if (Owner && Owner->HasAuthority()) {
+		Slots.Slots.SetNum(Capacity);
+		for (int32 i = 0; i < Capacity; i++) {
+			Slots.Slots[i].SlotIndex = i;
+			Slots.MarkItemDirty(Slots.Slots[i]);
+		}
+	}
+}
+
+void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UInventoryComponent, Slots);
+	DOREPLIFETIME(UInventoryComponent, Ammo);
+}
+
+int32 UInventoryComponent::AddItem(AItem* Item) {
+	const int32 SlotIndex{GetEmptySlot()};
+	if (SlotIndex != INDEX_NONE) {
+		SetItem(SlotIndex, Item);
+	}
+	return SlotIndex;
+}
+
+void UInventoryComponent::SetItem(int32 SlotIndex, AItem* Item) {
+	if (!Slots.Slots.IsValidIndex(SlotIndex)) {
+		return;
+	}
+
+	if (Item) {
+		Item->SetSlotIndex(SlotIndex);
+	}
+
+	FInventorySlot& Slot = Slots.Slots[SlotIndex];
+	if (Slot.Item != Item) {
+		Slot.Item = Item;
+		Slots.MarkItemDirty(Slot);
+	}
+	UpdateSlot(SlotIndex, Item);
+}
+
+AItem* UInventoryComponent::GetItem(int32 SlotIndex) const {
+	return Items.IsValidIndex(SlotIndex) ? Items[SlotIndex] : nullptr;
+}
+
+int32 UInventoryComponent::GetEmptySlot() const {
+	return FreeSlotMask ? static_cast<int32>(FMath::CountTrailingZeros(FreeSlotMask)) : INDEX_NONE;
+}
+
+void UInventoryComponent::UpdateSlot(int32 SlotIndex, AItem* Item) {
+	if (!Items.IsValidIndex(SlotIndex)) {
+		return;
+	}
+
+	Items[SlotIndex] = Item;
+	if (Item) {
+		FreeSlotMask &= ~(1u << SlotIndex);
+	} else {
+		FreeSlotMask |= 1u << SlotIndex;
+	}
+	OnSlotChanged.Broadcast(SlotIndex, Item);
+}
+
+int32 UInventoryComponent::GetAmmo(EAmmoType AmmoType) const {
+	const int32 Index{static_cast<int32>(AmmoType)};
+	return Ammo.IsValidIndex(Index) ? Ammo[Index] : 0;
+}
+
+void UInventoryComponent::SetAmmo(EAmmoType AmmoType, int32 Amount) {
+	const int32 Index{static_cast<int32>(AmmoType)};
+	if (!Ammo.IsValidIndex(Index)) {
+		return;
+	}
+
+	Amount = FMath::Max(Amount, 0);
+	if (Ammo[Index] != Amount) {
+		Ammo[Index] = Amount;
+		OnAmmoChanged.Broadcast(AmmoType, Amount);
+	}
+}
+
+void UInventoryComponent::OnRep_Ammo() {
+	for (int32 i = 0; i < Ammo.Num(); i++) {
+		OnAmmoChanged.Broadcast(static_cast<EAmmoType>(i), Ammo[i]);
+	}
+}
+
+void UInventoryComponent::AddAmmo(EAmmoType AmmoType, int32 Amount) {
+	SetAmmo(AmmoType, GetAmmo(AmmoType) + Amount);
+}
+
+int32 UInventoryComponent::TakeAmmo(EAmmoType AmmoType, int32 Amount) {
+	const int32 Carried{GetAmmo(AmmoType)};
+	const int32 Taken{FMath::Clamp(Amount, 0, Carried)};
+	SetAmmo(AmmoType, Carried - Taken);
+	return Taken;
+}
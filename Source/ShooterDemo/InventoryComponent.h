@@ -0,0 +1,133 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmmoType.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "InventoryComponent.generated.h"
+
+class AItem;
+class UInventoryComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventorySlotChangedDelegate, int32, SlotIndex, AItem*, Item);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryAmmoChangedDelegate, EAmmoType, AmmoType, int32, Amount);
+
+USTRUCT()
+struct FInventorySlot : public FFastArraySerializerItem {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AItem* Item{nullptr};
+
+	UPROPERTY()
+	int32 SlotIndex{INDEX_NONE};
+
+	//client side, keeps the free slot mask in sync with replicated slots
+	void PostReplicatedAdd(const struct FInventorySlotArray& InArraySerializer);
+	void PostReplicatedChange(const struct FInventorySlotArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FInventorySlotArray : public FFastArraySerializer {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FInventorySlot> Slots;
+
+	//not a property, so instances don't copy it from their archetype
+	UInventoryComponent* Owner{nullptr};
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInventorySlot, FInventorySlotArray>(Slots, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FInventorySlotArray> : public TStructOpsTypeTraitsBase2<FInventorySlotArray> {
+	enum {
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Fixed number of item slots and carried ammo for any actor. Free slots are a bit mask, ammo is
+ * indexed by ammo type, and only slots that changed are replicated
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SHOOTERDEMO_API UInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInventoryComponent();
+
+	virtual void InitializeComponent() override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	//puts the item into the lowest free slot, returns the slot or INDEX_NONE when full
+	int32 AddItem(AItem* Item);
+
+	//replaces whatever is in the slot, null empties it
+	void SetItem(int32 SlotIndex, AItem* Item);
+
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	AItem* GetItem(int32 SlotIndex) const;
+
+	//lowest free slot, INDEX_NONE when full
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetEmptySlot() const;
+
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	bool IsFull() const { return FreeSlotMask == 0; }
+
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetAmmo(EAmmoType AmmoType) const;
+
+	void SetAmmo(EAmmoType AmmoType, int32 Amount);
+	void AddAmmo(EAmmoType AmmoType, int32 Amount);
+
+	//takes up to amount of ammo, returns how much was taken
+	int32 TakeAmmo(EAmmoType AmmoType, int32 Amount);
+
+	FORCEINLINE int32 GetCapacity() const { return Capacity; }
+
+	//called for every slot that changes, on the server and on clients
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FInventorySlotChangedDelegate OnSlotChanged;
+
+	//called when carried ammo of a type changes, on the server and on clients
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FInventoryAmmoChangedDelegate OnAmmoChanged;
+
+private:
+	friend struct FInventorySlot;
+
+	//local view of the slots and free mask, on clients from replicated slots
+	void UpdateSlot(int32 SlotIndex, AItem* Item);
+
+	//the whole array is sent, every type is announced
+	UFUNCTION()
+	void OnRep_Ammo();
+
+	//number of slots, at most one per bit of the free slot mask
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = "true", ClampMin = "1", ClampMax = "32"))
+	int32 Capacity;
+
+	//slot items by index, the same on the server and on clients
+	UPROPERTY(Transient)
+	TArray<AItem*> Items;
+
+	//what goes over the wire, only built on the server
+	UPROPERTY(Replicated)
+	FInventorySlotArray Slots;
+
+	//carried ammo, one entry per ammo type
+	UPROPERTY(ReplicatedUsing = OnRep_Ammo)
+	TArray<int32> Ammo;
+
+	//bit per slot, set while the slot is empty
+	uint32 FreeSlotMask;
+};
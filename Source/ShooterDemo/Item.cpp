@@ -3,7 +3,10 @@
 
 #include "Item.h"
 
+#include "ItemClutterSubsystem.h"
 #include "ShooterCharacter.h"
+#include "ShooterDemo.h"
+#include "ShooterNames.h"
 #include "Camera/CameraComponent.h"
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
@@ -37,7 +40,8 @@ AItem::AItem() :
 	FresnelExponent(3.f),
 	FresnelReflectFraction(4.f),
 	SlotIndex(0),
-	bCharacterInventoryFull(false)
+	bCharacterInventoryFull(false),
+	bPooled(false)
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -47,14 +51,16 @@ AItem::AItem() :
 
 	CollisionBox = CreateDefaultSubobject<UBoxComponent>("Collision Box");
 	CollisionBox->SetupAttachment(ItemMesh);
+	CollisionBox->SetCollisionObjectType(ECC_Item);
 	CollisionBox->SetCollisionResponseToAllChannels(ECR_Ignore);
-	CollisionBox->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	CollisionBox->SetCollisionResponseToChannel(ECC_Interact, ECR_Block);
 
 	PickupWidget = CreateDefaultSubobject<UWidgetComponent>("Pick Up Widget");
 	PickupWidget->SetupAttachment(GetRootComponent());
 
 	AreaSphere = CreateDefaultSubobject<USphereComponent>("Area Sphere");
 	AreaSphere->SetupAttachment(GetRootComponent());
+	//stays WorldDynamic, pawn capsules ignore the Item object type and would never overlap it
 	
 }
 
@@ -109,9 +115,7 @@ void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 void AItem::SetActiveStars() {
 
 	//0 isn't used
-	for(int32 i = 0; i <= 5; i++) {
-		ActiveStars.Add(false);
-	}
+	ActiveStars.Init(false, 6);
 
 	switch (ItemRarity) {
 		case EItemRarity::EIR_Damaged:
@@ -159,12 +163,13 @@ void AItem::SetItemProperties(EItemState State) {
 		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 		//Set area sphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECR_Overlap);
+		AreaSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+		AreaSphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 
 		//set collision box properties
 		CollisionBox->SetCollisionResponseToAllChannels(ECR_Ignore);
-		CollisionBox->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+		CollisionBox->SetCollisionResponseToChannel(ECC_Interact, ECR_Block);
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 		break;
 	case EItemState::EIS_EquipInterping:
@@ -233,18 +238,27 @@ void AItem::SetItemProperties(EItemState State) {
 		ItemMesh->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
 
 		//Set area sphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECR_Overlap);
+		AreaSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+		AreaSphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 
 		//set collision box properties
 		CollisionBox->SetCollisionResponseToAllChannels(ECR_Ignore);
-		CollisionBox->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+		CollisionBox->SetCollisionResponseToChannel(ECC_Interact, ECR_Block);
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 		
 		break;
 	case EItemState::EIS_MAX: break;
 	default: ;
 	}
+
+	//items lying around or stowed in an inventory keep the pose they have; falling ones need the tick for physics
+	SetPoseTickEnabled(State == EItemState::EIS_EquipInterping || State == EItemState::EIS_Equipped || State == EItemState::EIS_Falling);
+}
+
+void AItem::SetPoseTickEnabled(bool bEnabled) {
+	ItemMesh->bPauseAnims = !bEnabled;
+	ItemMesh->SetComponentTickEnabled(bEnabled);
 }
 
 void AItem::FinishInterping() {
@@ -361,6 +375,18 @@ void AItem::OnConstruction(const FTransform& Transform) {
 	Super::OnConstruction(Transform);
 
 	//load the data in the item rarity data table
+	LoadRarityData();
+	
+	if (MaterialInstance) {
+		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
+		DynamicMaterialInstance->SetVectorParameterValue(ShooterNames::FresnelColourParam, GlowColour);
+		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
+		EnableGlowMaterial();
+	}
+
+}
+
+void AItem::LoadRarityData() {
 	//path
 	FString RarityTablePath{TEXT("DataTable'/Game/_Game/DataTable/ItemRarityDataTable.ItemRarityDataTable'")};
 
@@ -400,19 +426,11 @@ void AItem::OnConstruction(const FTransform& Transform) {
 			}
 		}
 	}
-	
-	if (MaterialInstance) {
-		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
-		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FersnelColour"), GlowColour);
-		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
-		EnableGlowMaterial();
-	}
-
 }
 
 void AItem::EnableGlowMaterial() {
 	if (DynamicMaterialInstance) {
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0);
+		DynamicMaterialInstance->SetScalarParameterValue(ShooterNames::GlowBlendAlphaParam, 0);
 	}
 }
 
@@ -442,9 +460,9 @@ void AItem::UpdatePulse() {
 	}
 
 	if (DynamicMaterialInstance) {
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), CurveValue.X * GlowAmount);
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), CurveValue.Y * FresnelExponent);
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), CurveValue.Z * FresnelReflectFraction);
+		DynamicMaterialInstance->SetScalarParameterValue(ShooterNames::GlowAmountParam, CurveValue.X * GlowAmount);
+		DynamicMaterialInstance->SetScalarParameterValue(ShooterNames::FresnelExponentParam, CurveValue.Y * FresnelExponent);
+		DynamicMaterialInstance->SetScalarParameterValue(ShooterNames::FresnelReflectFractionParam, CurveValue.Z * FresnelReflectFraction);
 		
 	}
 }
@@ -452,7 +470,7 @@ void AItem::UpdatePulse() {
 
 void AItem::DisableGlowMaterial() {
 	if (DynamicMaterialInstance) {
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1);
+		DynamicMaterialInstance->SetScalarParameterValue(ShooterNames::GlowBlendAlphaParam, 1);
 	}
 }
 
@@ -501,6 +519,12 @@ void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound) {
 	//store a handle to the character
 	Character = Char;
 
+	//picked up items are no longer clutter
+	UItemClutterSubsystem* ClutterSubsystem = GetWorld()->GetSubsystem<UItemClutterSubsystem>();
+	if (ClutterSubsystem) {
+		ClutterSubsystem->UnregisterDrop(this);
+	}
+
 	//get array index in interp locations with the lowest item count
 	InterpLocIndex = Char->GetInterpLocationIndex();
 	//add 1 to the item count for this interp location struct
@@ -528,3 +552,31 @@ void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound) {
 	
 }
 
+void AItem::SetItemRarity(EItemRarity Rarity) {
+	ItemRarity = Rarity;
+	SetActiveStars();
+	LoadRarityData();
+
+	if (DynamicMaterialInstance) {
+		DynamicMaterialInstance->SetVectorParameterValue(ShooterNames::FresnelColourParam, GlowColour);
+	}
+}
+
+void AItem::SetPoolActive(bool bActive) {
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
+	SetActorTickEnabled(bActive);
+
+	if (bActive) {
+		SetItemState(EItemState::EIS_Pickup);
+		bCanChangeCustomDepth = true;
+		DisableCustomDepth();
+		EnableGlowMaterial();
+		StartPulseTimer();
+	} else {
+		GetWorldTimerManager().ClearAllTimersForObject(this);
+		bInterping = false;
+		Character = nullptr;
+		SetItemState(EItemState::EIS_PickedUp);
+	}
+}
@@ -88,9 +88,15 @@ protected:
 	//sets stars based on rarity
 	void SetActiveStars();
 
+	//loads colours, stars and stencil for the current rarity from the rarity data table
+	void LoadRarityData();
+
 	//sets properties of the item components based on state
 	virtual void SetItemProperties(EItemState State);
 
+	//pauses pose ticking and anim evaluation while nobody holds or moves the item
+	void SetPoseTickEnabled(bool bEnabled);
+
 	//called when item interping has finished
 	void FinishInterping();
 
@@ -284,6 +290,10 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rarity", meta = (AllowPrivateAccess = "true"))
 	UTexture2D* ItemBackground;
 
+	//true when the item belongs to the loot pool and is recycled instead of destroyed
+	UPROPERTY(VisibleAnywhere, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	bool bPooled;
+
 public:
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex; }
 	FORCEINLINE void SetSlotIndex(int32 Index) { SlotIndex = Index; }
@@ -295,6 +305,10 @@ public:
 	FORCEINLINE USoundCue* GetPickupSound() const { return PickupSound; }
 	FORCEINLINE USoundCue* GetEquipSound() const { return EquipSound; }
 	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
+	FORCEINLINE void SetItemCount(int32 Count) { ItemCount = Count; }
+	FORCEINLINE EItemRarity GetItemRarity() const { return ItemRarity; }
+	FORCEINLINE bool IsPooled() const { return bPooled; }
+	FORCEINLINE void SetPooled(bool bInPool) { bPooled = bInPool; }
 	FORCEINLINE void SetCharacter(AShooterCharacter* Char) { Character = Char; }
 	FORCEINLINE void SetCharacterInventoryFull(bool bFull) { bCharacterInventoryFull = bFull; }
 	FORCEINLINE void SetPickupSound(USoundCue* Sound){ PickupSound = Sound; }
@@ -313,6 +327,12 @@ public:
 	FORCEINLINE void SetMaterialIndex(int32 Index) { MaterialIndex = Index; }
 	
 	void SetItemState(EItemState State);
+
+	//changes rarity at run-time (loot drops); updates stars, colours and glow
+	void SetItemRarity(EItemRarity Rarity);
+
+	//wakes a pooled item up as a pickup, or hides and stops it when it goes back to the pool
+	virtual void SetPoolActive(bool bActive);
 	
 	//called from the shooter character class
 	void StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound = false);
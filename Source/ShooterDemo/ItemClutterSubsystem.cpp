@@ -0,0 +1,245 @@
+// Andrei Nikitin 2022
+
+
+#include "ItemClutterSubsystem.h"
+
+#include "Ammo.h"
+#include "Item.h"
+#include "LootSubsystem.h"
+#include "ShooterDemo.h"
+#include "Weapon.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Items"), STAT_DroppedItems, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Weapons"), STAT_DroppedWeapons, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Ammo"), STAT_DroppedAmmo, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Merged Ammo Stacks"), STAT_MergedAmmoStacks, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Despawned Drops"), STAT_DespawnedDrops, STATGROUP_ShooterDemo);
+
+static FAutoConsoleCommandWithWorld ItemClutterReportCommand(
+	TEXT("ShooterDemo.Items.Report"),
+	TEXT("Logs the dropped items tracked by the clutter manager"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+		const UItemClutterSubsystem* ClutterSubsystem = World ? World->GetSubsystem<UItemClutterSubsystem>() : nullptr;
+		if (ClutterSubsystem) {
+			ClutterSubsystem->LogReport();
+		}
+	}));
+
+namespace {
+	FIntPoint GetGridCell(const FVector& Location, float CellSize) {
+		return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	}
+
+	//weapons are always worth more than ammo, then higher rarity wins
+	int32 GetDropValue(const AItem* Item) {
+		int32 Value{static_cast<int32>(Item->GetItemRarity())};
+		if (Cast<AWeapon>(Item)) {
+			Value += static_cast<int32>(EItemRarity::EIR_MAX);
+		}
+		return Value;
+	}
+}
+
+UItemClutterSubsystem::UItemClutterSubsystem() :
+	TimeUntilUpdate(0.f),
+	UpdateInterval(0.5f),
+	MergeRadius(150.f),
+	AreaSize(1000.f),
+	MaxItemsPerArea(12),
+	GlobalItemBudget(128)
+{
+
+}
+
+void UItemClutterSubsystem::Deinitialize() {
+	Drops.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UItemClutterSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemClutterSubsystem, STATGROUP_Tickables);
+}
+
+void UItemClutterSubsystem::RegisterDrop(AItem* Item) {
+	if (!Item) {
+		return;
+	}
+
+	UnregisterDrop(Item);
+
+	FTrackedDrop Drop;
+	Drop.Item = Item;
+	Drop.DropTime = GetWorld()->GetTimeSeconds();
+	Drops.Add(Drop);
+}
+
+void UItemClutterSubsystem::UnregisterDrop(AItem* Item) {
+	Drops.RemoveAll([Item](const FTrackedDrop& Drop) {
+		return Drop.Item.Get() == Item;
+	});
+}
+
+void UItemClutterSubsystem::Tick(float DeltaTime) {
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f) {
+		return;
+	}
+	TimeUntilUpdate = UpdateInterval;
+
+	RemoveStaleDrops();
+	MergeAmmoStacks();
+	EnforceBudgets();
+	UpdateStats();
+}
+
+void UItemClutterSubsystem::RemoveStaleDrops() {
+	Drops.RemoveAll([](const FTrackedDrop& Drop) {
+		const AItem* Item = Drop.Item.Get();
+		if (!Item || Item->IsPendingKill()) {
+			return true;
+		}
+
+		//anything not lying on the ground belongs to someone again
+		const EItemState State{Item->GetItemState()};
+		return State != EItemState::EIS_Pickup && State != EItemState::EIS_Falling;
+	});
+}
+
+void UItemClutterSubsystem::MergeAmmoStacks() {
+	const float MergeRadiusSquared{FMath::Square(MergeRadius)};
+
+	//stacks that will absorb later drops, bucketed by merge radius sized cells
+	TMap<FIntPoint, TArray<int32>> StacksByCell;
+	TArray<int32> MergedDrops;
+
+	auto FindStack = [&](const AAmmo* Ammo, const FIntPoint& Cell) -> AAmmo* {
+		for (int32 X = -1; X <= 1; X++) {
+			for (int32 Y = -1; Y <= 1; Y++) {
+				const TArray<int32>* CellStacks = StacksByCell.Find(Cell + FIntPoint(X, Y));
+				if (!CellStacks) {
+					continue;
+				}
+				for (const int32 StackIndex : *CellStacks) {
+					AAmmo* Stack = static_cast<AAmmo*>(Drops[StackIndex].Item.Get());
+					if (Stack->GetAmmoType() == Ammo->GetAmmoType() &&
+						FVector::DistSquared(Stack->GetActorLocation(), Ammo->GetActorLocation()) <= MergeRadiusSquared) {
+						return Stack;
+					}
+				}
+			}
+		}
+		return nullptr;
+	};
+
+	for (int32 i = 0; i < Drops.Num(); i++) {
+		AAmmo* Ammo = Cast<AAmmo>(Drops[i].Item.Get());
+		//only merge ammo that has come to rest
+		if (!Ammo || Ammo->GetItemState() != EItemState::EIS_Pickup) {
+			continue;
+		}
+
+		const FIntPoint Cell{GetGridCell(Ammo->GetActorLocation(), MergeRadius)};
+		AAmmo* Stack = FindStack(Ammo, Cell);
+		if (Stack) {
+			Stack->SetItemCount(Stack->GetItemCount() + Ammo->GetItemCount());
+			MergedDrops.Add(i);
+		} else {
+			StacksByCell.FindOrAdd(Cell).Add(i);
+		}
+	}
+
+	//back to front so the remaining indices stay valid
+	for (int32 i = MergedDrops.Num() - 1; i >= 0; i--) {
+		AItem* Item = Drops[MergedDrops[i]].Item.Get();
+		Drops.RemoveAt(MergedDrops[i]);
+		ReleaseDrop(Item);
+	}
+
+	Stats.TotalMerged += MergedDrops.Num();
+}
+
+void UItemClutterSubsystem::EnforceBudgets() {
+	TArray<int32> DespawnDrops;
+
+	//per-area budget
+	TMap<FIntPoint, TArray<int32>> DropsByArea;
+	for (int32 i = 0; i < Drops.Num(); i++) {
+		DropsByArea.FindOrAdd(GetGridCell(Drops[i].Item->GetActorLocation(), AreaSize)).Add(i);
+	}
+
+	for (auto& AreaPair : DropsByArea) {
+		TArray<int32>& AreaDrops = AreaPair.Value;
+		const int32 Excess{AreaDrops.Num() - MaxItemsPerArea};
+		if (Excess > 0) {
+			SortByDespawnPriority(AreaDrops);
+			DespawnDrops.Append(AreaDrops.GetData(), Excess);
+		}
+	}
+
+	//global budget on whatever survived the area pass
+	const int32 GlobalExcess{Drops.Num() - DespawnDrops.Num() - GlobalItemBudget};
+	if (GlobalExcess > 0) {
+		TSet<int32> AlreadyDespawning{DespawnDrops};
+		TArray<int32> RemainingDrops;
+		for (int32 i = 0; i < Drops.Num(); i++) {
+			if (!AlreadyDespawning.Contains(i)) {
+				RemainingDrops.Add(i);
+			}
+		}
+		SortByDespawnPriority(RemainingDrops);
+		DespawnDrops.Append(RemainingDrops.GetData(), GlobalExcess);
+	}
+
+	DespawnDrops.Sort();
+	for (int32 i = DespawnDrops.Num() - 1; i >= 0; i--) {
+		AItem* Item = Drops[DespawnDrops[i]].Item.Get();
+		Drops.RemoveAt(DespawnDrops[i]);
+		ReleaseDrop(Item);
+	}
+
+	Stats.TotalDespawned += DespawnDrops.Num();
+}
+
+void UItemClutterSubsystem::SortByDespawnPriority(TArray<int32>& DropIndices) const {
+	DropIndices.Sort([this](int32 A, int32 B) {
+		const int32 ValueA{GetDropValue(Drops[A].Item.Get())};
+		const int32 ValueB{GetDropValue(Drops[B].Item.Get())};
+		if (ValueA != ValueB) {
+			return ValueA < ValueB;
+		}
+		return Drops[A].DropTime < Drops[B].DropTime;
+	});
+}
+
+void UItemClutterSubsystem::ReleaseDrop(AItem* Item) {
+	ULootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<ULootSubsystem>();
+	if (LootSubsystem) {
+		LootSubsystem->ReleaseItem(Item);
+	} else if (Item) {
+		Item->Destroy();
+	}
+}
+
+void UItemClutterSubsystem::UpdateStats() {
+	Stats.NumDrops = Drops.Num();
+	Stats.NumWeapons = 0;
+	Stats.NumAmmo = 0;
+	for (const FTrackedDrop& Drop : Drops) {
+		if (Cast<AWeapon>(Drop.Item.Get())) {
+			Stats.NumWeapons++;
+		} else if (Cast<AAmmo>(Drop.Item.Get())) {
+			Stats.NumAmmo++;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_DroppedItems, Stats.NumDrops);
+	SET_DWORD_STAT(STAT_DroppedWeapons, Stats.NumWeapons);
+	SET_DWORD_STAT(STAT_DroppedAmmo, Stats.NumAmmo);
+	SET_DWORD_STAT(STAT_MergedAmmoStacks, Stats.TotalMerged);
+	SET_DWORD_STAT(STAT_DespawnedDrops, Stats.TotalDespawned);
+}
+
+void UItemClutterSubsystem::LogReport() const {
+	UE_LOG(LogShooterDemo, Log, TEXT("Dropped items: %d (%d weapons, %d ammo), merged stacks: %d, despawned: %d"),
+		Stats.NumDrops, Stats.NumWeapons, Stats.NumAmmo, Stats.TotalMerged, Stats.TotalDespawned);
+}
@@ -0,0 +1,111 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "ItemClutterSubsystem.generated.h"
+
+class AItem;
+
+//counts reported by the clutter manager
+USTRUCT(BlueprintType)
+struct FItemClutterStats {
+	GENERATED_BODY()
+
+	//dropped items currently lying in the world
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumDrops{0};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumWeapons{0};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumAmmo{0};
+
+	//ammo stacks merged into another stack since the world started
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 TotalMerged{0};
+
+	//drops removed to stay within budget since the world started
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 TotalDespawned{0};
+};
+
+/**
+ * Keeps dropped items in check: merges nearby ammo of the same type and despawns
+ * the oldest / least valuable drops when an area or the whole world is over budget
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UItemClutterSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UItemClutterSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//starts tracking an item that was dropped into the world (thrown weapon, loot)
+	void RegisterDrop(AItem* Item);
+
+	//stops tracking an item, e.g. when it gets picked up
+	void UnregisterDrop(AItem* Item);
+
+	UFUNCTION(BlueprintPure, Category = "Items")
+	FItemClutterStats GetStats() const { return Stats; }
+
+	//writes the current counts to the log
+	void LogReport() const;
+
+private:
+	struct FTrackedDrop {
+		TWeakObjectPtr<AItem> Item;
+		float DropTime{0.f};
+	};
+
+	//forgets items that were destroyed, picked up or recycled
+	void RemoveStaleDrops();
+
+	//folds ammo into an older stack of the same type within merge radius
+	void MergeAmmoStacks();
+
+	//despawns drops over the per-area and global budgets
+	void EnforceBudgets();
+
+	void UpdateStats();
+
+	//sorts drop indices so the first one is the best candidate for despawning
+	void SortByDespawnPriority(TArray<int32>& DropIndices) const;
+
+	//releases an untracked drop to the loot pool (or destroys it)
+	void ReleaseDrop(AItem* Item);
+
+	//oldest drop first
+	TArray<FTrackedDrop> Drops;
+
+	FItemClutterStats Stats;
+
+	float TimeUntilUpdate;
+
+	//seconds between clutter passes
+	UPROPERTY(Config)
+	float UpdateInterval;
+
+	//ammo of the same type closer than this is merged into one stack
+	UPROPERTY(Config)
+	float MergeRadius;
+
+	//size of the square areas used for the per-area budget
+	UPROPERTY(Config)
+	float AreaSize;
+
+	UPROPERTY(Config)
+	int32 MaxItemsPerArea;
+
+	UPROPERTY(Config)
+	int32 GlobalItemBudget;
+};
@@ -0,0 +1,214 @@
+// Andrei Nikitin 2022
+
+
+#include "LootSubsystem.h"
+
+#include "Ammo.h"
+#include "CombatRandomSubsystem.h"
+#include "Item.h"
+#include "ItemClutterSubsystem.h"
+#include "ShooterDemo.h"
+#include "Weapon.h"
+
+ULootSubsystem::ULootSubsystem() :
+	PoolSizePerClass(8),
+	MaxActivationsPerFrame(4),
+	MaxSpawnsPerFrame(1),
+	DropScatterRadius(80.f)
+{
+
+}
+
+void ULootSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	//drops repeat with the combat seed
+	UCombatRandomSubsystem* CombatRandom = Cast<UCombatRandomSubsystem>(Collection.InitializeDependency(UCombatRandomSubsystem::StaticClass()));
+	if (CombatRandom) {
+		LootStream = CombatRandom->MakeStream(TEXT("Loot"));
+	} else {
+		LootStream.Initialize(FMath::Rand());
+	}
+}
+
+void ULootSubsystem::Deinitialize() {
+	RegisteredTables.Empty();
+	CompiledTables.Empty();
+	Pools.Empty();
+	WarmupQueue.Empty();
+	PendingDrops.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId ULootSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULootSubsystem, STATGROUP_Tickables);
+}
+
+void ULootSubsystem::RegisterLootTable(UDataTable* LootTable) {
+	if (!LootTable || CompiledTables.Contains(LootTable)) {
+		return;
+	}
+
+	if (LootTable->GetRowStruct() != FLootTableRow::StaticStruct()) {
+		UE_LOG(LogShooterDemo, Warning, TEXT("%s is not a loot table"), *LootTable->GetName());
+		return;
+	}
+
+	FCompiledLootTable& Compiled = CompiledTables.Add(LootTable);
+	RegisteredTables.Add(LootTable);
+
+	TArray<float> RowWeights;
+	for (const auto& RowPair : LootTable->GetRowMap()) {
+		const FLootTableRow* Row = reinterpret_cast<const FLootTableRow*>(RowPair.Value);
+		if (!Row || !Row->ItemClass) {
+			continue;
+		}
+
+		Compiled.Rows.Add(*Row);
+		RowWeights.Add(Row->Weight);
+		Compiled.RarityTables.AddDefaulted_GetRef().Build(Row->RarityWeights.ToArray());
+
+		//warm up a pool the first time a class shows up in any table
+		UClass* ItemClass = Row->ItemClass.Get();
+		if (!Pools.Contains(ItemClass)) {
+			Pools.Add(ItemClass);
+			for (int32 i = 0; i < PoolSizePerClass; i++) {
+				WarmupQueue.Add(ItemClass);
+			}
+		}
+	}
+
+	Compiled.RowTable.Build(RowWeights);
+}
+
+void ULootSubsystem::RequestDrop(UDataTable* LootTable, const FVector& Location, int32 NumDrops) {
+	if (!LootTable) {
+		return;
+	}
+
+	RegisterLootTable(LootTable);
+	const FCompiledLootTable* Compiled = CompiledTables.Find(LootTable);
+	if (!Compiled || Compiled->RowTable.IsEmpty()) {
+		return;
+	}
+
+	for (int32 i = 0; i < NumDrops; i++) {
+		const int32 RowIndex{Compiled->RowTable.Sample(LootStream)};
+		const FLootTableRow& Row = Compiled->Rows[RowIndex];
+
+		FPendingDrop Drop;
+		Drop.ItemClass = Row.ItemClass.Get();
+		Drop.WeaponType = Row.WeaponType;
+
+		const int32 RarityIndex{Compiled->RarityTables[RowIndex].Sample(LootStream)};
+		Drop.Rarity = RarityIndex == INDEX_NONE ? EItemRarity::EIR_Common : static_cast<EItemRarity>(RarityIndex);
+		Drop.ItemCount = LootStream.RandRange(Row.MinItemCount, FMath::Max(Row.MinItemCount, Row.MaxItemCount));
+
+		//scatter the drops so they don't stack on top of each other
+		const float Angle{LootStream.FRandRange(0.f, 2.f * PI)};
+		const float Radius{LootStream.FRandRange(0.f, DropScatterRadius)};
+		Drop.Location = Location + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.f);
+		Drop.Yaw = LootStream.FRandRange(0.f, 360.f);
+
+		PendingDrops.Add(Drop);
+	}
+}
+
+void ULootSubsystem::ReleaseItem(AItem* Item) {
+	if (!Item) {
+		return;
+	}
+
+	if (!Item->IsPooled()) {
+		Item->Destroy();
+		return;
+	}
+
+	Item->SetPoolActive(false);
+	Pools.FindOrAdd(Item->GetClass()).AddUnique(Item);
+}
+
+void ULootSubsystem::Tick(float DeltaTime) {
+	int32 SpawnBudget{MaxSpawnsPerFrame};
+
+	//drops first so warm-up never delays loot the player is waiting for
+	int32 Activations{0};
+	int32 DropIndex{0};
+	while (DropIndex < PendingDrops.Num() && Activations < MaxActivationsPerFrame) {
+		const FPendingDrop& Drop = PendingDrops[DropIndex];
+		AItem* Item = AcquireItem(Drop.ItemClass, SpawnBudget);
+		if (!Item) {
+			//pool is dry and we are out of spawns this frame; try again next frame
+			DropIndex++;
+			continue;
+		}
+
+		ActivateDrop(Item, Drop);
+		PendingDrops.RemoveAt(DropIndex, 1, false);
+		Activations++;
+	}
+
+	while (SpawnBudget > 0 && WarmupQueue.Num() > 0) {
+		UClass* ItemClass = WarmupQueue.Pop(false);
+		AItem* Item = SpawnPooledItem(ItemClass);
+		if (Item) {
+			Pools.FindOrAdd(ItemClass).Add(Item);
+		}
+		SpawnBudget--;
+	}
+}
+
+AItem* ULootSubsystem::AcquireItem(UClass* ItemClass, int32& SpawnBudget) {
+	TArray<TWeakObjectPtr<AItem>>& Pool = Pools.FindOrAdd(ItemClass);
+	while (Pool.Num() > 0) {
+		AItem* Item = Pool.Pop(false).Get();
+		if (Item) {
+			return Item;
+		}
+	}
+
+	if (SpawnBudget <= 0) {
+		return nullptr;
+	}
+
+	SpawnBudget--;
+	return SpawnPooledItem(ItemClass);
+}
+
+AItem* ULootSubsystem::SpawnPooledItem(UClass* ItemClass) {
+	if (!ItemClass) {
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AItem* Item = GetWorld()->SpawnActor<AItem>(ItemClass, FTransform::Identity, SpawnParams);
+	if (Item) {
+		Item->SetPooled(true);
+		Item->SetPoolActive(false);
+	}
+
+	return Item;
+}
+
+void ULootSubsystem::ActivateDrop(AItem* Item, const FPendingDrop& Drop) {
+	Item->SetActorLocationAndRotation(Drop.Location, FRotator(0.f, Drop.Yaw, 0.f), false, nullptr, ETeleportType::TeleportPhysics);
+
+	AWeapon* Weapon = Cast<AWeapon>(Item);
+	if (Weapon && Drop.WeaponType != EWeaponType::EWT_MAX) {
+		Weapon->SetWeaponType(Drop.WeaponType);
+	}
+
+	if (Cast<AAmmo>(Item)) {
+		Item->SetItemCount(Drop.ItemCount);
+	}
+
+	Item->SetItemRarity(Drop.Rarity);
+	Item->SetPoolActive(true);
+
+	UItemClutterSubsystem* ClutterSubsystem = GetWorld()->GetSubsystem<UItemClutterSubsystem>();
+	if (ClutterSubsystem) {
+		ClutterSubsystem->RegisterDrop(Item);
+	}
+}
@@ -0,0 +1,96 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LootTable.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "LootSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Rolls loot tables and spawns the drops from recycled item pools, a few per frame
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API ULootSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	ULootSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//builds the alias tables for a loot table and queues pool warm-up for its item classes
+	void RegisterLootTable(UDataTable* LootTable);
+
+	//rolls the table NumDrops times and queues the drops around Location
+	void RequestDrop(UDataTable* LootTable, const FVector& Location, int32 NumDrops = 1);
+
+	//returns a pooled item to its pool, destroys anything else
+	void ReleaseItem(AItem* Item);
+
+private:
+	struct FCompiledLootTable {
+		TArray<FLootTableRow> Rows;
+		FAliasTable RowTable;
+		//rarity table for each row
+		TArray<FAliasTable> RarityTables;
+	};
+
+	struct FPendingDrop {
+		UClass* ItemClass{nullptr};
+		EWeaponType WeaponType{EWeaponType::EWT_MAX};
+		EItemRarity Rarity{EItemRarity::EIR_Common};
+		int32 ItemCount{0};
+		FVector Location{FVector::ZeroVector};
+		float Yaw{0.f};
+	};
+
+	//takes a free item out of the pool, spawning one if the pool is empty and the spawn budget allows
+	AItem* AcquireItem(UClass* ItemClass, int32& SpawnBudget);
+
+	//spawns a sleeping item straight into the pool
+	AItem* SpawnPooledItem(UClass* ItemClass);
+
+	void ActivateDrop(AItem* Item, const FPendingDrop& Drop);
+
+	//tables kept alive while they have compiled data
+	UPROPERTY()
+	TArray<UDataTable*> RegisteredTables;
+
+	TMap<const UDataTable*, FCompiledLootTable> CompiledTables;
+
+	//free items for each item class
+	TMap<UClass*, TArray<TWeakObjectPtr<AItem>>> Pools;
+
+	//classes still waiting for a pooled item to be spawned
+	UPROPERTY()
+	TArray<UClass*> WarmupQueue;
+
+	//drops waiting for a free item
+	TArray<FPendingDrop> PendingDrops;
+
+	FRandomStream LootStream;
+
+	//items pre-spawned for each class a loot table can drop
+	UPROPERTY(Config)
+	int32 PoolSizePerClass;
+
+	//max pooled items woken up per frame
+	UPROPERTY(Config)
+	int32 MaxActivationsPerFrame;
+
+	//max SpawnActor calls per frame, shared by warm-up and empty pools
+	UPROPERTY(Config)
+	int32 MaxSpawnsPerFrame;
+
+	//drops are scattered in a ring of this radius around the drop location
+	UPROPERTY(Config)
+	float DropScatterRadius;
+};
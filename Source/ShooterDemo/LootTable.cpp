@@ -0,0 +1,74 @@
+// Andrei Nikitin 2022
+
+
+#include "LootTable.h"
+
+void FAliasTable::Build(const TArray<float>& Weights) {
+	Probability.Reset();
+	Alias.Reset();
+
+	const int32 Num{Weights.Num()};
+	float TotalWeight{0.f};
+	for (const float Weight : Weights) {
+		TotalWeight += FMath::Max(Weight, 0.f);
+	}
+
+	if (Num == 0 || TotalWeight <= 0.f) {
+		return;
+	}
+
+	Probability.SetNumUninitialized(Num);
+	Alias.SetNumUninitialized(Num);
+
+	//weights scaled so the average column is exactly 1
+	TArray<float> Scaled;
+	Scaled.SetNumUninitialized(Num);
+	TArray<int32> Small;
+	TArray<int32> Large;
+	Small.Reserve(Num);
+	Large.Reserve(Num);
+
+	for (int32 i = 0; i < Num; i++) {
+		Scaled[i] = FMath::Max(Weights[i], 0.f) * Num / TotalWeight;
+		if (Scaled[i] < 1.f) {
+			Small.Add(i);
+		} else {
+			Large.Add(i);
+		}
+	}
+
+	//fill each under-full column with the remainder of an over-full one
+	while (Small.Num() > 0 && Large.Num() > 0) {
+		const int32 Less{Small.Pop(false)};
+		const int32 More{Large.Pop(false)};
+
+		Probability[Less] = Scaled[Less];
+		Alias[Less] = More;
+
+		Scaled[More] = (Scaled[More] + Scaled[Less]) - 1.f;
+		if (Scaled[More] < 1.f) {
+			Small.Add(More);
+		} else {
+			Large.Add(More);
+		}
+	}
+
+	//whatever is left is full up to float error
+	for (const int32 Index : Large) {
+		Probability[Index] = 1.f;
+		Alias[Index] = Index;
+	}
+	for (const int32 Index : Small) {
+		Probability[Index] = 1.f;
+		Alias[Index] = Index;
+	}
+}
+
+int32 FAliasTable::Sample(const FRandomStream& Stream) const {
+	if (IsEmpty()) {
+		return INDEX_NONE;
+	}
+
+	const int32 Column{Stream.RandHelper(Probability.Num())};
+	return Stream.GetFraction() < Probability[Column] ? Column : Alias[Column];
+}
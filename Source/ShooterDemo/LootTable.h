@@ -0,0 +1,79 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "Item.h"
+#include "WeaponType.h"
+#include "LootTable.generated.h"
+
+//relative chance of each rarity for a loot row
+USTRUCT(BlueprintType)
+struct FLootRarityWeights {
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Damaged{0.f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Common{1.f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Uncommon{0.f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Rare{0.f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Legendary{0.f};
+
+	//weights ordered by EItemRarity
+	TArray<float> ToArray() const { return { Damaged, Common, Uncommon, Rare, Legendary }; }
+};
+
+//one possible drop of a loot table
+USTRUCT(BlueprintType)
+struct FLootTableRow : public FTableRowBase {
+	GENERATED_BODY()
+
+	//relative chance of this row being picked
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Weight{1.f};
+
+	//item blueprint to spawn (weapon or ammo)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<AItem> ItemClass;
+
+	//weapon data row applied to weapon drops, DefaultMAX keeps the blueprint's weapon type
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EWeaponType WeaponType{EWeaponType::EWT_MAX};
+
+	//range for the item count (amount of ammo)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MinItemCount{1};
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxItemCount{1};
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FLootRarityWeights RarityWeights;
+};
+
+/**
+ * Walker/Vose alias table; O(n) to build, O(1) to sample a weighted index
+ */
+struct SHOOTERDEMO_API FAliasTable {
+	//builds the table from non-negative weights; empty if all weights are zero
+	void Build(const TArray<float>& Weights);
+
+	//returns a weighted random index or INDEX_NONE if the table is empty
+	int32 Sample(const FRandomStream& Stream) const;
+
+	FORCEINLINE bool IsEmpty() const { return Probability.Num() == 0; }
+
+private:
+	//chance of keeping the rolled column instead of taking its alias
+	TArray<float> Probability;
+	TArray<int32> Alias;
+};
@@ -0,0 +1,65 @@
+// Andrei Nikitin 2022
+
+
+#include "MeshSocketHandle.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+FMeshSocketHandle::FMeshSocketHandle(FName InName) :
+	Name(InName)
+{
+
+}
+
+void FMeshSocketHandle::SetName(FName InName) {
+	if (Name != InName) {
+		Name = InName;
+		ResolvedMesh.Reset();
+	}
+}
+
+void FMeshSocketHandle::Resolve(const USkeletalMeshComponent* Component) {
+	const USkeletalMesh* Mesh = Component ? Component->SkeletalMesh : nullptr;
+	if (Mesh == ResolvedMesh.Get() && ResolvedMesh.IsValid()) {
+		return;
+	}
+
+	ResolvedMesh = Mesh;
+	Socket = nullptr;
+	BoneIndex = INDEX_NONE;
+	if (!Mesh || Name.IsNone()) {
+		return;
+	}
+
+	//mesh sockets, then skeleton sockets, both searched by name
+	Socket = Mesh->FindSocket(Name);
+	BoneIndex = Component->GetBoneIndex(Socket ? Socket->BoneName : Name);
+}
+
+const USkeletalMeshSocket* FMeshSocketHandle::GetSocket(const USkeletalMeshComponent* Component) {
+	Resolve(Component);
+	return Socket;
+}
+
+int32 FMeshSocketHandle::GetBoneIndex(const USkeletalMeshComponent* Component) {
+	Resolve(Component);
+	return BoneIndex;
+}
+
+bool FMeshSocketHandle::GetTransform(const USkeletalMeshComponent* Component, FTransform& OutTransform) {
+	if (!Component) {
+		return false;
+	}
+
+	Resolve(Component);
+	if (BoneIndex == INDEX_NONE) {
+		OutTransform = Component->GetComponentTransform();
+		return false;
+	}
+
+	const FTransform BoneTransform{Component->GetBoneTransform(BoneIndex)};
+	OutTransform = Socket ? Socket->GetSocketLocalTransform() * BoneTransform : BoneTransform;
+	return true;
+}
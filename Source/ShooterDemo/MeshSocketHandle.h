@@ -0,0 +1,44 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USkeletalMesh;
+class USkeletalMeshComponent;
+class USkeletalMeshSocket;
+
+/**
+ * Socket or bone of a skeletal mesh looked up by name once. The socket and bone index are kept
+ * for the mesh they were found on and looked up again only when the component's mesh changes
+ */
+struct SHOOTERDEMO_API FMeshSocketHandle {
+	FMeshSocketHandle() {}
+	explicit FMeshSocketHandle(FName InName);
+
+	//changes the socket / bone name, dropping the cached lookup if it differs
+	void SetName(FName InName);
+	FORCEINLINE FName GetName() const { return Name; }
+
+	//null when the name is a bone or doesn't exist on the mesh
+	const USkeletalMeshSocket* GetSocket(const USkeletalMeshComponent* Component);
+
+	//bone the socket is attached to, or the bone itself
+	int32 GetBoneIndex(const USkeletalMeshComponent* Component);
+
+	//world transform of the socket / bone, false (component transform) when it isn't on the mesh
+	bool GetTransform(const USkeletalMeshComponent* Component, FTransform& OutTransform);
+
+private:
+	void Resolve(const USkeletalMeshComponent* Component);
+
+	FName Name;
+
+	//mesh the socket and bone index were looked up on
+	TWeakObjectPtr<const USkeletalMesh> ResolvedMesh;
+
+	//owned by the mesh or its skeleton, valid while the resolved mesh is
+	const USkeletalMeshSocket* Socket{nullptr};
+
+	int32 BoneIndex{INDEX_NONE};
+};
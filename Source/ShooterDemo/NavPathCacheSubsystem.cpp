@@ -0,0 +1,135 @@
+// Andrei Nikitin 2022
+
+
+#include "NavPathCacheSubsystem.h"
+
+#include "NavigationSystem.h"
+#include "ShooterDemo.h"
+#include "NavMesh/NavMeshPath.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Cache Hits"), STAT_PathCacheHits, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Cache Misses"), STAT_PathCacheMisses, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cached Paths"), STAT_CachedPaths, STATGROUP_ShooterDemo);
+
+UNavPathCacheSubsystem::UNavPathCacheSubsystem() :
+	NavVersion(0),
+	QuantizationSize(50.f),
+	MaxCachedPaths(256)
+{
+
+}
+
+bool UNavPathCacheSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	if (!Super::ShouldCreateSubsystem(Outer)) {
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UNavPathCacheSubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld);
+	if (NavSys) {
+		NavSys->OnNavigationGenerationFinishedDelegate.AddDynamic(this, &UNavPathCacheSubsystem::OnNavigationGenerationFinished);
+	}
+}
+
+void UNavPathCacheSubsystem::Deinitialize() {
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys) {
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UNavPathCacheSubsystem::OnNavigationGenerationFinished);
+	}
+	Invalidate();
+
+	Super::Deinitialize();
+}
+
+void UNavPathCacheSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData) {
+	NavVersion++;
+	Invalidate();
+}
+
+void UNavPathCacheSubsystem::Invalidate() {
+	CachedPaths.Empty();
+	CacheOrder.Empty();
+	SET_DWORD_STAT(STAT_CachedPaths, 0);
+}
+
+UNavPathCacheSubsystem::FPathKey UNavPathCacheSubsystem::MakeKey(const FPathFindingQuery& Query) const {
+	FPathKey Key;
+	Key.Start = Quantize(Query.StartLocation);
+	Key.End = Quantize(Query.EndLocation);
+	Key.NavData = Query.NavData.Get();
+	Key.NavVersion = NavVersion;
+	return Key;
+}
+
+FIntVector UNavPathCacheSubsystem::Quantize(const FVector& Location) const {
+	//floor so cells around the origin are the same size as every other cell
+	return FIntVector(FMath::FloorToInt(Location.X / QuantizationSize), FMath::FloorToInt(Location.Y / QuantizationSize), FMath::FloorToInt(Location.Z / QuantizationSize));
+}
+
+bool UNavPathCacheSubsystem::FindPath(const FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) {
+	const FCachedPath* CachedPath = Query.NavData.IsValid() ? CachedPaths.Find(MakeKey(Query)) : nullptr;
+	if (!CachedPath) {
+		INC_DWORD_STAT(STAT_PathCacheMisses);
+		return false;
+	}
+
+	//every user gets its own path, path following registers observers and may repath it
+	FNavPathSharedPtr Path;
+	if (CachedPath->bNavMeshPath) {
+		FNavMeshPath* NavMeshPath = new FNavMeshPath();
+		NavMeshPath->PathCorridor = CachedPath->PathCorridor;
+		NavMeshPath->PathCorridorCost = CachedPath->PathCorridorCost;
+		Path = MakeShareable(NavMeshPath);
+	} else {
+		Path = MakeShareable(new FNavigationPath());
+	}
+
+	TArray<FNavPathPoint>& PathPoints = Path->GetPathPoints();
+	PathPoints = CachedPath->PathPoints;
+	//exact ends instead of the ones of whoever filled the cache
+	PathPoints[0].Location = Query.StartLocation;
+	PathPoints.Last().Location = Query.EndLocation;
+
+	Path->SetNavigationDataUsed(Query.NavData.Get());
+	Path->SetQuerier(Query.Owner.Get());
+	Path->SetTimeStamp(GetWorld()->GetTimeSeconds());
+	Path->MarkReady();
+
+	OutPath = Path;
+	INC_DWORD_STAT(STAT_PathCacheHits);
+	return true;
+}
+
+void UNavPathCacheSubsystem::StorePath(const FPathFindingQuery& Query, const FNavPathSharedPtr& Path) {
+	if (!Path.IsValid() || !Path->IsValid() || Path->IsPartial() || !Query.NavData.IsValid()) {
+		return;
+	}
+
+	const FPathKey Key{MakeKey(Query)};
+	if (CachedPaths.Contains(Key)) {
+		return;
+	}
+
+	if (CacheOrder.Num() >= MaxCachedPaths && CacheOrder.Num() > 0) {
+		CachedPaths.Remove(CacheOrder[0]);
+		CacheOrder.RemoveAt(0, 1, false);
+	}
+
+	FCachedPath& CachedPath = CachedPaths.Add(Key);
+	CachedPath.PathPoints = Path->GetPathPoints();
+	const FNavMeshPath* NavMeshPath = Path->CastPath<FNavMeshPath>();
+	if (NavMeshPath) {
+		CachedPath.bNavMeshPath = true;
+		CachedPath.PathCorridor = NavMeshPath->PathCorridor;
+		CachedPath.PathCorridorCost = NavMeshPath->PathCorridorCost;
+	}
+	CacheOrder.Add(Key);
+
+	SET_DWORD_STAT(STAT_CachedPaths, CachedPaths.Num());
+}
@@ -0,0 +1,84 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavigationData.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NavPathCacheSubsystem.generated.h"
+
+/**
+ * Reuses paths between the same quantized start and end locations, e.g. patrol legs shared by
+ * many enemies. Cached paths are copied for every user and dropped when the navmesh is rebuilt
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UNavPathCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UNavPathCacheSubsystem();
+
+	//only created for game and PIE worlds
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	//fills OutPath with a fresh copy of a cached path for the query, false on a miss
+	bool FindPath(const FPathFindingQuery& Query, FNavPathSharedPtr& OutPath);
+
+	//remembers a complete path found for the query
+	void StorePath(const FPathFindingQuery& Query, const FNavPathSharedPtr& Path);
+
+	//drops every cached path
+	void Invalidate();
+
+private:
+	struct FPathKey {
+		FIntVector Start;
+		FIntVector End;
+		const ANavigationData* NavData{nullptr};
+		uint32 NavVersion{0};
+
+		bool operator==(const FPathKey& Other) const {
+			return Start == Other.Start && End == Other.End && NavData == Other.NavData && NavVersion == Other.NavVersion;
+		}
+
+		friend uint32 GetTypeHash(const FPathKey& Key) {
+			return HashCombine(HashCombine(GetTypeHash(Key.Start), GetTypeHash(Key.End)), HashCombine(PointerHash(Key.NavData), Key.NavVersion));
+		}
+	};
+
+	struct FCachedPath {
+		TArray<FNavPathPoint> PathPoints;
+		//navmesh polys along the path, empty for other navigation data
+		TArray<NavNodeRef> PathCorridor;
+		TArray<float> PathCorridorCost;
+		bool bNavMeshPath{false};
+	};
+
+	FPathKey MakeKey(const FPathFindingQuery& Query) const;
+
+	//cell of the quantization grid the location falls into
+	FIntVector Quantize(const FVector& Location) const;
+
+	//bound to the navigation system's dynamic delegate
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+	TMap<FPathKey, FCachedPath> CachedPaths;
+
+	//insertion order, oldest first, for eviction
+	TArray<FPathKey> CacheOrder;
+
+	//bumped whenever the navmesh changes
+	uint32 NavVersion;
+
+	//grid size start and end locations are snapped to
+	UPROPERTY(Config)
+	float QuantizationSize;
+
+	UPROPERTY(Config)
+	int32 MaxCachedPaths;
+};
@@ -0,0 +1,124 @@
+// Andrei Nikitin 2022
+
+
+#include "PathRequestQueueSubsystem.h"
+
+#include "NavigationSystem.h"
+#include "ShooterDemo.h"
+#include "NavMesh/NavMeshPath.h"
+#include "NavMesh/RecastNavMesh.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Path Requests"), STAT_QueuedPathRequests, STATGROUP_ShooterDemo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("In Flight Path Requests"), STAT_InFlightPathRequests, STATGROUP_ShooterDemo);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Path Request Latency Avg (ms)"), STAT_PathRequestLatencyAvg, STATGROUP_ShooterDemo);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Path Request Latency Max (ms)"), STAT_PathRequestLatencyMax, STATGROUP_ShooterDemo);
+
+UPathRequestQueueSubsystem::UPathRequestQueueSubsystem() :
+	LatencySum(0.0),
+	MaxLatency(0.0),
+	NumFinished(0),
+	bEnabled(true),
+	MaxRequestsPerFrame(4),
+	MaxRequestsInFlight(16)
+{
+
+}
+
+void UPathRequestQueueSubsystem::Deinitialize() {
+	QueuedRequests.Empty();
+	InFlightRequests.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UPathRequestQueueSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPathRequestQueueSubsystem, STATGROUP_Tickables);
+}
+
+FNavPathSharedPtr UPathRequestQueueSubsystem::RequestPath(const FPathFindingQuery& Query, const FOnQueuedPathFinished& OnFinished) {
+	const ANavigationData* NavData = Query.NavData.Get();
+	if (!NavData) {
+		return nullptr;
+	}
+
+	//same path type the navigation data would have made, not ready until filled
+	FNavPathSharedPtr PendingPath;
+	if (NavData->IsA<ARecastNavMesh>()) {
+		PendingPath = MakeShareable(new FNavMeshPath());
+	} else {
+		PendingPath = MakeShareable(new FNavigationPath());
+	}
+	PendingPath->SetQuerier(Query.Owner.Get());
+
+	FPathRequest& Request = QueuedRequests.AddDefaulted_GetRef();
+	Request.Query = Query;
+	Request.PendingPath = PendingPath;
+	Request.OnFinished = OnFinished;
+	Request.RequestTime = FPlatformTime::Seconds();
+	return PendingPath;
+}
+
+void UPathRequestQueueSubsystem::Tick(float DeltaTime) {
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+	int32 NumSent{0};
+	int32 NumDropped{0};
+	while (NavSys && NumSent + NumDropped < QueuedRequests.Num() && NumSent < MaxRequestsPerFrame && InFlightRequests.Num() < MaxRequestsInFlight) {
+		FPathRequest& Request = QueuedRequests[NumSent + NumDropped];
+
+		//nobody is waiting for it any more
+		if (!Request.OnFinished.IsBound() || Request.PendingPath.IsUnique()) {
+			NumDropped++;
+			continue;
+		}
+
+		const uint32 QueryId{NavSys->FindPathAsync(Request.Query.NavAgentProperties, Request.Query,
+			FNavPathQueryDelegate::CreateUObject(this, &UPathRequestQueueSubsystem::OnAsyncPathFound))};
+		InFlightRequests.Add(QueryId, MoveTemp(Request));
+		NumSent++;
+	}
+	QueuedRequests.RemoveAt(0, NumSent + NumDropped, false);
+
+	SET_DWORD_STAT(STAT_QueuedPathRequests, QueuedRequests.Num());
+	SET_DWORD_STAT(STAT_InFlightPathRequests, InFlightRequests.Num());
+	if (NumFinished > 0) {
+		SET_FLOAT_STAT(STAT_PathRequestLatencyAvg, LatencySum / NumFinished * 1000.0);
+		SET_FLOAT_STAT(STAT_PathRequestLatencyMax, MaxLatency * 1000.0);
+	}
+	LatencySum = 0.0;
+	MaxLatency = 0.0;
+	NumFinished = 0;
+}
+
+void UPathRequestQueueSubsystem::OnAsyncPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr FoundPath) {
+	FPathRequest Request;
+	if (!InFlightRequests.RemoveAndCopyValue(QueryId, Request)) {
+		return;
+	}
+
+	const double Latency{FPlatformTime::Seconds() - Request.RequestTime};
+	LatencySum += Latency;
+	MaxLatency = FMath::Max(MaxLatency, Latency);
+	NumFinished++;
+
+	const bool bSuccess{Result == ENavigationQueryResult::Success && FoundPath.IsValid() && FoundPath->IsValid()};
+	if (bSuccess) {
+		FillPendingPath(*Request.PendingPath, *FoundPath);
+	}
+	Request.OnFinished.ExecuteIfBound(Request.Query, Request.PendingPath, bSuccess);
+}
+
+void UPathRequestQueueSubsystem::FillPendingPath(FNavigationPath& PendingPath, const FNavigationPath& FoundPath) {
+	PendingPath.GetPathPoints() = FoundPath.GetPathPoints();
+
+	FNavMeshPath* PendingNavMeshPath = PendingPath.CastPath<FNavMeshPath>();
+	const FNavMeshPath* FoundNavMeshPath = FoundPath.CastPath<FNavMeshPath>();
+	if (PendingNavMeshPath && FoundNavMeshPath) {
+		PendingNavMeshPath->PathCorridor = FoundNavMeshPath->PathCorridor;
+		PendingNavMeshPath->PathCorridorCost = FoundNavMeshPath->PathCorridorCost;
+	}
+
+	PendingPath.SetNavigationDataUsed(FoundPath.GetNavigationDataUsed());
+	PendingPath.SetIsPartial(FoundPath.IsPartial());
+	PendingPath.SetTimeStamp(FoundPath.GetTimeStamp());
+	PendingPath.MarkReady();
+}
@@ -0,0 +1,71 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavigationData.h"
+#include "ShooterTickableWorldSubsystem.h"
+#include "PathRequestQueueSubsystem.generated.h"
+
+//query that was asked for, the path it filled and whether a usable path was found
+DECLARE_DELEGATE_ThreeParams(FOnQueuedPathFinished, const FPathFindingQuery&, FNavPathSharedPtr, bool);
+
+/**
+ * Spreads pathfinding over frames. Requests hand out a path that isn't ready yet (path following
+ * waits on it), a limited number are sent to the navigation system's async queries per frame and
+ * the found path is copied into the waiting one on the game thread before the callback runs
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API UPathRequestQueueSubsystem : public UShooterTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPathRequestQueueSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//queues the query and returns the path it will fill, invalid if the query has no navigation data
+	FNavPathSharedPtr RequestPath(const FPathFindingQuery& Query, const FOnQueuedPathFinished& OnFinished);
+
+	FORCEINLINE bool IsEnabled() const { return bEnabled; }
+
+private:
+	struct FPathRequest {
+		FPathFindingQuery Query;
+		FNavPathSharedPtr PendingPath;
+		FOnQueuedPathFinished OnFinished;
+		double RequestTime{0.0};
+	};
+
+	void OnAsyncPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr FoundPath);
+
+	//copies a found path into the one handed out when the request was queued
+	static void FillPendingPath(FNavigationPath& PendingPath, const FNavigationPath& FoundPath);
+
+	//waiting to be sent, oldest first
+	TArray<FPathRequest> QueuedRequests;
+
+	//sent to the navigation system, by query id
+	TMap<uint32, FPathRequest> InFlightRequests;
+
+	//latency of the requests finished this frame
+	double LatencySum;
+	double MaxLatency;
+	int32 NumFinished;
+
+	//off falls back to synchronous pathfinding
+	UPROPERTY(Config)
+	bool bEnabled;
+
+	//async queries started per frame
+	UPROPERTY(Config)
+	int32 MaxRequestsPerFrame;
+
+	//async queries allowed to run at once
+	UPROPERTY(Config)
+	int32 MaxRequestsInFlight;
+};
@@ -4,124 +4,144 @@
 #include "ShooterAnimInstance.h"
 
 #include "ShooterCharacter.h"
+#include "ShooterNames.h"
 #include "Weapon.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 
-UShooterAnimInstance::UShooterAnimInstance() :
-	Speed(0.f),
-	bIsInAir(false),
-	bIsAccelerating(false),
-	MovementOffsetYaw(0.f),
-	LastMovementOffsetYaw(0.f),
-	bAiming(false),
-	TIPCharacterYaw(0.f),
-	TIPCharacterYawLastFrame(0.f),
-	RootYawOffset(0.f),
-	Pitch(0.f),
-	bReloading(false),
-	OffsetState(EOffsetState::EOS_Hip),
-	CharacterRotation(FRotator(0.f)),
-	CharacterRotationLastFrame(FRotator(0.f)),
-	YawDelta(0.f),
-	bCrouching(false),
-	RecoilWeight(1.f),
-	bTurningInPlace(false),
-	EquippedWeaponType(EWeaponType::EWT_MAX),
-	bShouldUseFABRIK(false)
+FShooterAnimInstanceProxy::FShooterAnimInstanceProxy(UAnimInstance* InAnimInstance) :
+	FAnimInstanceProxy(InAnimInstance),
+	ShooterAnimInstance(Cast<UShooterAnimInstance>(InAnimInstance))
 {
-	
+
 }
 
-void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime) {
+void FShooterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) {
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	if (ShooterAnimInstance && !ShooterAnimInstance->ShooterCharacter) {
+		ShooterAnimInstance->ShooterCharacter = Cast<AShooterCharacter>(InAnimInstance->TryGetPawnOwner());
+	}
+	const AShooterCharacter* ShooterCharacter = ShooterAnimInstance ? ShooterAnimInstance->ShooterCharacter : nullptr;
+	const bool bHadCharacter{bHasCharacter};
+	bHasCharacter = ShooterCharacter != nullptr;
 	if (!ShooterCharacter) {
-		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+		return;
+	}
+
+	ShotCount = ShooterCharacter->GetShotCount();
+	if (!bHadCharacter) {
+		//no recoil for shots fired before this instance saw the character
+		RecoilShotCount = ShotCount;
 	}
-	if(ShooterCharacter) {
-		bCrouching = ShooterCharacter->GetCrouching();
-		bReloading = ShooterCharacter->GetCombatState() == ECombatState::ECS_Reloading;
-		bEquipping = ShooterCharacter->GetCombatState() == ECombatState::ECS_Equipping;
-		bShouldUseFABRIK = ShooterCharacter->GetCombatState() == ECombatState::ECS_Unoccupied || ShooterCharacter->GetCombatState() == ECombatState::ECS_FireTimerInProgress;
-		
+
+	Velocity = ShooterCharacter->GetVelocity();
+	const UCharacterMovementComponent* Movement = ShooterCharacter->GetCharacterMovement();
+	bFalling = Movement->IsFalling();
+	bAccelerating = Movement->GetCurrentAcceleration().SizeSquared() > 0.f;
+	AimRotation = ShooterCharacter->GetBaseAimRotation();
+	ActorRotation = ShooterCharacter->GetActorRotation();
+	CombatState = ShooterCharacter->GetCombatState();
+	bCharacterCrouching = ShooterCharacter->GetCrouching();
+	bCharacterAiming = ShooterCharacter->GetAiming();
+
+	const AWeapon* EquippedWeapon = ShooterCharacter->GetEquippedWeapon();
+	bHasWeapon = EquippedWeapon != nullptr;
+	if (EquippedWeapon) {
+		WeaponType = EquippedWeapon->GetWeaponType();
+		RecoilPitchKick = EquippedWeapon->GetRecoilPitchKick();
+		RecoilBackKick = EquippedWeapon->GetRecoilBackKick();
+	}
+
+	//curves from the last evaluation
+	TurningCurve = InAnimInstance->GetCurveValue(ShooterNames::TurningCurve);
+	RotationCurveValue = InAnimInstance->GetCurveValue(ShooterNames::RotationCurve);
+}
+
+void FShooterAnimInstanceProxy::Update(float DeltaSeconds) {
+	Super::Update(DeltaSeconds);
+
+	//the game thread doesn't touch the instance while its update is in flight
+	if (!ShooterAnimInstance) {
+		return;
+	}
+
+	if (bHasCharacter) {
+		UShooterAnimInstance& Instance = *ShooterAnimInstance;
+		Instance.bCrouching = bCharacterCrouching;
+		Instance.bReloading = CombatState == ECombatState::ECS_Reloading;
+		Instance.bEquipping = CombatState == ECombatState::ECS_Equipping;
+		Instance.bShouldUseFABRIK = CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_FireTimerInProgress;
+
 		//Get the lateral speed of character from velocity
-		FVector Velocity{ShooterCharacter->GetVelocity()};
-		Velocity.Z = 0;
-		Speed = Velocity.Size();
+		FVector LateralVelocity{Velocity};
+		LateralVelocity.Z = 0;
+		Instance.Speed = LateralVelocity.Size();
 
 		//Is the character in the air
-		bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
+		Instance.bIsInAir = bFalling;
 
 		//is the character Accelerating
-		if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f) {
-			bIsAccelerating = true;
-		} else {
-			bIsAccelerating = false;
-		}
+		Instance.bIsAccelerating = bAccelerating;
 
-		FRotator AimRotation{ShooterCharacter->GetBaseAimRotation()};
-		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ShooterCharacter->GetVelocity());
+		const FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(Velocity);
 
-		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
+		Instance.MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
 
-		if(ShooterCharacter->GetVelocity().Size() > 0.f) {
-			LastMovementOffsetYaw = MovementOffsetYaw;
+		if(Velocity.Size() > 0.f) {
+			Instance.LastMovementOffsetYaw = Instance.MovementOffsetYaw;
 		}
 
-		bAiming = ShooterCharacter->GetAiming();
+		Instance.bAiming = bCharacterAiming;
 
-		if (bReloading) {
-			OffsetState = EOffsetState::EOS_Reloading;
-		} else if (bIsInAir) {
-			OffsetState = EOffsetState::EOS_InAir;
-		} else if (ShooterCharacter->GetAiming()) {
-			OffsetState = EOffsetState::EOS_Aiming;
+		if (Instance.bReloading) {
+			Instance.OffsetState = EOffsetState::EOS_Reloading;
+		} else if (Instance.bIsInAir) {
+			Instance.OffsetState = EOffsetState::EOS_InAir;
+		} else if (bCharacterAiming) {
+			Instance.OffsetState = EOffsetState::EOS_Aiming;
 		} else {
-			OffsetState = EOffsetState::EOS_Hip;
+			Instance.OffsetState = EOffsetState::EOS_Hip;
 		}
 		//check if shooter character has a valid equipped weapon
-		if (ShooterCharacter->GetEquippedWeapon()) {
-			EquippedWeaponType = ShooterCharacter->GetEquippedWeapon()->GetWeaponType();
+		if (bHasWeapon) {
+			Instance.EquippedWeaponType = WeaponType;
 		}
 	}
 
 	TurnInPlace();
-	Lean(DeltaTime);
-	
-}
-
-void UShooterAnimInstance::NativeInitializeAnimation() {
-	Super::NativeInitializeAnimation();
-	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+	Lean(DeltaSeconds);
+	UpdateRecoil(DeltaSeconds);
 }
 
-void UShooterAnimInstance::TurnInPlace() {
-	if (!ShooterCharacter) {
+void FShooterAnimInstanceProxy::TurnInPlace() {
+	if (!bHasCharacter) {
 		return;
 	}
+	UShooterAnimInstance& Instance = *ShooterAnimInstance;
 
-	Pitch = ShooterCharacter->GetBaseAimRotation().Pitch;
+	Instance.Pitch = AimRotation.Pitch;
 
-	if(Speed > 0 || bIsInAir) {
+	if(Instance.Speed > 0 || Instance.bIsInAir) {
 		//dont want to turn in place when character is moving
-		RootYawOffset = 0.f;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		Instance.RootYawOffset = 0.f;
+		TIPCharacterYaw = ActorRotation.Yaw;
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
 		RotationCurveLastFrame = 0.f;
 		RotationCurve = 0.f;
 	} else {
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = ActorRotation.Yaw;
 		const float TIPYawDelta { TIPCharacterYaw - TIPCharacterYawLastFrame };
 
 		//root yaw offset updated and clamped to [-180, 180]
+		float& RootYawOffset = Instance.RootYawOffset;
 		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPYawDelta);
 
-		const float Turning{ GetCurveValue(TEXT("Turning")) };
-
-		if (Turning > 0) {
-			bTurningInPlace = true;
+		if (TurningCurve > 0) {
+			Instance.bTurningInPlace = true;
 			RotationCurveLastFrame = RotationCurve;
-			RotationCurve = GetCurveValue(TEXT("CurveRotation"));
+			RotationCurve = RotationCurveValue;
 			const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 
 			//rootYawOffset> 0, -> turning left; root yaw offset < 0 -> turn right
@@ -133,48 +153,107 @@ void UShooterAnimInstance::TurnInPlace() {
 				(RootYawOffset > 0) ? RootYawOffset -= YawExcess : RootYawOffset += YawExcess;
 			}
 		} else {
-			bTurningInPlace = false;
+			Instance.bTurningInPlace = false;
 		}
 	}
 
 	//set the recoil weight
-	if (bTurningInPlace) {
+	const bool bReloading{Instance.bReloading};
+	const bool bEquipping{Instance.bEquipping};
+	if (Instance.bTurningInPlace) {
 		if (bReloading || bEquipping) {
-			RecoilWeight = 1.f;
+			Instance.RecoilWeight = 1.f;
 		} else {
-			RecoilWeight = 0.f;
+			Instance.RecoilWeight = 0.f;
 		}
 	} else { // not turning in place
-		if(bCrouching) {
+		if(Instance.bCrouching) {
 			if (bReloading || bEquipping) {
-				RecoilWeight = 1.f;
+				Instance.RecoilWeight = 1.f;
 			} else {
-				RecoilWeight = 0.1f;
+				Instance.RecoilWeight = 0.1f;
 			}
 		} else {
-			if(bAiming || bReloading || bEquipping) {
-				RecoilWeight = 1.f;
+			if(Instance.bAiming || bReloading || bEquipping) {
+				Instance.RecoilWeight = 1.f;
 			} else {
-				RecoilWeight = 0.5f;
+				Instance.RecoilWeight = 0.5f;
 			}
 		}
 	}
 }
 
-void UShooterAnimInstance::Lean(float DeltaTime) {
-	if (!ShooterCharacter) {
+void FShooterAnimInstanceProxy::Lean(float DeltaSeconds) {
+	if (!bHasCharacter || DeltaSeconds <= 0.f) {
 		return;
 	}
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ShooterCharacter->GetActorRotation();
+	CharacterRotation = ActorRotation;
 
 	const FRotator Delta{ UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame) };
 
-	const float Target{ Delta.Yaw / DeltaTime };
-	const float Interp{ FMath::FInterpTo(YawDelta, Target, DeltaTime, 6.f) };
+	const float Target{ Delta.Yaw / DeltaSeconds };
+	float& YawDelta = ShooterAnimInstance->YawDelta;
+	const float Interp{ FMath::FInterpTo(YawDelta, Target, DeltaSeconds, 6.f) };
 	YawDelta = FMath::Clamp(Interp, -90.f, 90.f);
+}
+
+void FShooterAnimInstanceProxy::UpdateRecoil(float DeltaSeconds) {
+	if (!bHasCharacter || DeltaSeconds <= 0.f) {
+		return;
+	}
+	UShooterAnimInstance& Instance = *ShooterAnimInstance;
+
+	//several shots in one long frame each add their kick
+	const uint32 NewShots{ShotCount - RecoilShotCount};
+	RecoilShotCount = ShotCount;
+	if (NewShots > 0) {
+		RecoilPitchSpring.Velocity += RecoilPitchKick * NewShots;
+		RecoilBackSpring.Velocity += RecoilBackKick * NewShots;
+	}
+
+	Instance.RecoilPitch = UKismetMathLibrary::FloatSpringInterp(Instance.RecoilPitch, 0.f, RecoilPitchSpring, Instance.RecoilStiffness, Instance.RecoilDamping, DeltaSeconds);
+	Instance.RecoilBack = UKismetMathLibrary::FloatSpringInterp(Instance.RecoilBack, 0.f, RecoilBackSpring, Instance.RecoilStiffness, Instance.RecoilDamping, DeltaSeconds);
+}
+
+UShooterAnimInstance::UShooterAnimInstance() :
+	Speed(0.f),
+	bIsInAir(false),
+	bIsAccelerating(false),
+	MovementOffsetYaw(0.f),
+	LastMovementOffsetYaw(0.f),
+	bAiming(false),
+	RootYawOffset(0.f),
+	Pitch(0.f),
+	bReloading(false),
+	OffsetState(EOffsetState::EOS_Hip),
+	YawDelta(0.f),
+	bCrouching(false),
+	RecoilWeight(1.f),
+	RecoilPitch(0.f),
+	RecoilBack(0.f),
+	RecoilStiffness(200.f),
+	RecoilDamping(0.6f),
+	bTurningInPlace(false),
+	EquippedWeaponType(EWeaponType::EWT_MAX),
+	bShouldUseFABRIK(false)
+{
+	
+}
 
+void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime) {
 	
 }
 
+void UShooterAnimInstance::NativeInitializeAnimation() {
+	Super::NativeInitializeAnimation();
+	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+}
+
+FAnimInstanceProxy* UShooterAnimInstance::CreateAnimInstanceProxy() {
+	return new FShooterAnimInstanceProxy(this);
+}
 
+void UShooterAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) {
+	delete static_cast<FShooterAnimInstanceProxy*>(InProxy);
+}
@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "ShooterCharacter.h"
 #include "WeaponType.h"
 #include "ShooterAnimInstance.generated.h"
 
@@ -18,6 +21,80 @@ enum class EOffsetState : uint8 {
 	EOS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+class UShooterAnimInstance;
+
+/**
+ * Runs the shooter anim update on a worker thread. Character state is copied on the game thread
+ * in PreUpdate, everything derived from it is worked out in Update before the graph reads it
+ */
+USTRUCT()
+struct FShooterAnimInstanceProxy : public FAnimInstanceProxy {
+	GENERATED_BODY()
+
+	FShooterAnimInstanceProxy() {}
+	FShooterAnimInstanceProxy(UAnimInstance* InAnimInstance);
+
+protected:
+	//game thread
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	//worker thread
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	//Handle turning in place vriables
+	void TurnInPlace();
+
+	//Handle calculations for leaning whie running
+	void Lean(float DeltaSeconds);
+
+	//springs the additive recoil back to rest, kicking it for shots fired since the last update
+	void UpdateRecoil(float DeltaSeconds);
+
+	UShooterAnimInstance* ShooterAnimInstance{nullptr};
+
+	/*character state copied in pre update*/
+	bool bHasCharacter{false};
+	FVector Velocity{FVector::ZeroVector};
+	bool bFalling{false};
+	bool bAccelerating{false};
+	FRotator AimRotation{FRotator::ZeroRotator};
+	FRotator ActorRotation{FRotator::ZeroRotator};
+	ECombatState CombatState{ECombatState::ECS_Unoccupied};
+	bool bCharacterCrouching{false};
+	bool bCharacterAiming{false};
+	bool bHasWeapon{false};
+	EWeaponType WeaponType{EWeaponType::EWT_MAX};
+	float TurningCurve{0.f};
+	float RotationCurveValue{0.f};
+	uint32 ShotCount{0};
+	float RecoilPitchKick{0.f};
+	float RecoilBackKick{0.f};
+
+	//shot count the recoil was last kicked for
+	uint32 RecoilShotCount{0};
+
+	FFloatSpringState RecoilPitchSpring;
+	FFloatSpringState RecoilBackSpring;
+
+	//yaw of the character this frame; updated when standing still && not in air
+	float TIPCharacterYaw{0.f};
+
+	//yaw of the character previous frame; updated when standing still && not in air
+	float TIPCharacterYawLastFrame{0.f};
+
+	//rotation curve value this fram
+	float RotationCurve{0.f};
+
+	//last frame
+	float RotationCurveLastFrame{0.f};
+
+	//character yaw this frame
+	FRotator CharacterRotation{FRotator::ZeroRotator};
+
+	//character yaw last frame
+	FRotator CharacterRotationLastFrame{FRotator::ZeroRotator};
+};
+
 /**
  * 
  */
@@ -29,19 +106,19 @@ class SHOOTERDEMO_API UShooterAnimInstance : public UAnimInstance
 public:
 	UShooterAnimInstance();
 	
-	UFUNCTION(BlueprintCallable)
+	//the update runs in FShooterAnimInstanceProxy now, remove the call from the event graph
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Animation properties are updated by the anim instance proxy"))
 	void UpdateAnimationProperties(float DeltaTime);
 	
 	virtual void NativeInitializeAnimation() override;
 
 protected:
-	//Handle turning in place vriables
-	void TurnInPlace();
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
 
-	//Handle calculations for leaning whie running
-	void Lean(float DeltaTime);
-	
 private:
+	friend struct FShooterAnimInstanceProxy;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
 	class AShooterCharacter* ShooterCharacter{nullptr};
 
@@ -66,21 +143,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
 	bool bAiming;
 
-	//yaw of the character this frame; updated when standing still && not in air
-	float TIPCharacterYaw;
-
-	//yaw of the character previous frame; updated when standing still && not in air
-	float TIPCharacterYawLastFrame;
-
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Turn In Place", meta = (AllowPrivateAccess = "true"))
 	float RootYawOffset;
 
-	//rotation curve value this fram
-	float RotationCurve;
-
-	//last frame
-	float RotationCurveLastFrame;
-
 	//the pitch of the aim rotation used for aim offset
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Turn In Place", meta = (AllowPrivateAccess = "true"))
 	float Pitch;
@@ -93,12 +158,6 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Turn In Place", meta = (AllowPrivateAccess = "true"))
 	EOffsetState OffsetState;
 
-	//character yaw this frame
-	FRotator CharacterRotation;
-
-	//character yaw last frame
-	FRotator CharacterRotationLastFrame;
-
 	//yaw delta used for leaning in the running blendspace
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Lean", meta = (AllowPrivateAccess = "true"))
 	float YawDelta;
@@ -115,6 +174,21 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float RecoilWeight;
 
+	//additive weapon recoil for a modify bone node (add to existing) on the hand
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float RecoilPitch;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float RecoilBack;
+
+	//spring stiffness pulling the recoil back to rest
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float RecoilStiffness;
+
+	//1 settles without overshooting, lower values bounce
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float RecoilDamping;
+
 	//true when turning in place
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	bool bTurningInPlace;
@@ -8,8 +8,16 @@
 #include "DrawDebugHelpers.h"
 #include "Enemy.h"
 #include "EnemyController.h"
+#include "EnemyPerceptionSubsystem.h"
+#include "HitNumberComponent.h"
+#include "InventoryComponent.h"
 #include "Item.h"
+#include "ItemClutterSubsystem.h"
+#include "LootSubsystem.h"
+#include "ShooterPlayerController.h"
+#include "SurfaceQuerySubsystem.h"
 #include "Weapon.h"
+#include "Animation/AnimMontage.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/WidgetComponent.h"
@@ -17,9 +25,10 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
 #include "Particles/ParticleSystemComponent.h"
-#include "PhysicalMaterials/PhysicalMaterial.h"
 #include "ShooterDemo.h"
+#include "ShooterNames.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Sound/SoundCue.h"
 
@@ -118,6 +127,10 @@ AShooterCharacter::AShooterCharacter() :
 	GetCharacterMovement()->JumpZVelocity = 600.f;
 	GetCharacterMovement()->AirControl = 0.2f;
 
+	//bullets and pickup traces go through the capsule
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Weapon, ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Interact, ECR_Ignore);
+
 	HandSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("HandSceneComp"));
 
 	//Create interpolation components
@@ -141,7 +154,10 @@ AShooterCharacter::AShooterCharacter() :
 
 	InterpComp6 = CreateDefaultSubobject<USceneComponent>(TEXT("InterpolationComponent6"));
 	InterpComp6->SetupAttachment(GetFollowCamera());
-	
+
+	InventoryComponent = CreateDefaultSubobject<UInventoryComponent>(TEXT("Inventory"));
+
+	RightHandSocket.SetName(ShooterNames::RightHandSocket);
 }
 
 float AShooterCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator,
@@ -154,7 +170,7 @@ float AShooterCharacter::TakeDamage(float DamageAmount, FDamageEvent const& Dama
 
 		AEnemyController* EnemyController = Cast<AEnemyController>(EventInstigator);
 		if (EnemyController) {
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("CharacterDead"), true);
+			EnemyController->GetEnemyBlackboard().SetCharacterDead(true);
 		}
 	} else {
 		Health -= DamageAmount;
@@ -173,25 +189,49 @@ void AShooterCharacter::BeginPlay()
 		CameraCurrentFOV = CameraDefaultFOV;
 	}
 
+	//the HUD widgets read Inventory and AmmoMap, slots may have replicated already
+	InventoryComponent->OnSlotChanged.AddDynamic(this, &AShooterCharacter::OnInventorySlotChanged);
+	InventoryComponent->OnAmmoChanged.AddDynamic(this, &AShooterCharacter::OnInventoryAmmoChanged);
+	OnInventorySlotChanged(INDEX_NONE, nullptr);
+	for (int32 i = 0; i < static_cast<int32>(EAmmoType::EAT_MAX); i++) {
+		const EAmmoType AmmoType{static_cast<EAmmoType>(i)};
+		OnInventoryAmmoChanged(AmmoType, InventoryComponent->GetAmmo(AmmoType));
+	}
+
 	//Spawn default weapon and equip it
 	EquipWeapon(SpawnDefaultWeapon());
-	Inventory.Add(EquippedWeapon);
-	EquippedWeapon->SetSlotIndex(0);
+	InventoryComponent->SetItem(0, EquippedWeapon);
 	EquippedWeapon->DisableCustomDepth();
 	EquippedWeapon->DisableGlowMaterial();
 	EquippedWeapon->SetCharacter(this);
 	
-	InitializeAmmoMap();
+	InitializeAmmo();
 
 	GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
+	SetLookRates();
 
 	//create finterp locations struct for each interp location add to array
 	InitializeInterpLocations();
 
+	//let enemies see the player
+	UEnemyPerceptionSubsystem* PerceptionSubsystem = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (PerceptionSubsystem) {
+		PerceptionSubsystem->RegisterTarget(this);
+	}
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	UEnemyPerceptionSubsystem* PerceptionSubsystem = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (PerceptionSubsystem) {
+		PerceptionSubsystem->UnregisterTarget(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AShooterCharacter::StartCrosshairBulletFire() {
 	bFiringBullet = true;
+	WakeTick();
 
 	GetWorldTimerManager().SetTimer(CrosshairShootTimer,
 		this,
@@ -201,12 +241,59 @@ void AShooterCharacter::StartCrosshairBulletFire() {
 
 
 void AShooterCharacter::FireButtonPressed() {
-	bFireButtonPressed = true;
-	FireWeapon();
+	RecordCombatCommand(ECombatCommandType::ECCT_FirePressed);
 }
 
 void AShooterCharacter::FireButtonReleased() {
-	bFireButtonPressed = false;
+	RecordCombatCommand(ECombatCommandType::ECCT_FireReleased);
+}
+
+void AShooterCharacter::RecordCombatCommand(ECombatCommandType Type, int32 SlotIndex) {
+	//world time is the same for the whole frame, add how far into the frame the input was handled
+	//a fixed time step doesn't follow the wall clock, so the offset is meaningless there and clamped to the frame otherwise
+	const double FrameOffset{FApp::UseFixedTimeStep() ? 0.0 : FMath::Clamp(FPlatformTime::Seconds() - FApp::GetCurrentTime(), 0.0, FApp::GetDeltaTime())};
+	const float Time{GetWorld()->GetTimeSeconds() + static_cast<float>(FrameOffset * GetActorTimeDilation())};
+	CombatCommands.Add(Type, Time, SlotIndex);
+	//the pawn ticks after its controller handled input, so the command runs this frame
+	WakeTick();
+}
+
+void AShooterCharacter::ProcessCombatCommands() {
+	if (CombatCommands.HasPending()) {
+		CombatCommands.Consume([this](const FCombatCommand& Command) { HandleCombatCommand(Command); });
+	}
+}
+
+void AShooterCharacter::HandleCombatCommand(const FCombatCommand& Command) {
+	switch (Command.Type) {
+	case ECombatCommandType::ECCT_FirePressed:
+		bFireButtonPressed = true;
+		FireWeapon();
+		break;
+	case ECombatCommandType::ECCT_FireReleased:
+		bFireButtonPressed = false;
+		break;
+	case ECombatCommandType::ECCT_AimPressed:
+		bAimingButtonPressed = true;
+		if(CombatState != ECombatState::ECS_Reloading && CombatState != ECombatState::ECS_Equipping && CombatState != ECombatState::ECS_Stunned) {
+			Aim();
+		}
+		break;
+	case ECombatCommandType::ECCT_AimReleased:
+		bAimingButtonPressed = false;
+		StopAiming();
+		break;
+	case ECombatCommandType::ECCT_Reload:
+		ReloadWeapon();
+		break;
+	case ECombatCommandType::ECCT_EquipSlot:
+		if (EquippedWeapon && EquippedWeapon->GetSlotIndex() != Command.SlotIndex) {
+			ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), Command.SlotIndex);
+		}
+		break;
+	default:
+		break;
+	}
 }
 
 void AShooterCharacter::StartFireTimer() {
@@ -236,14 +323,18 @@ void AShooterCharacter::AutoFireReset() {
 	if (WeaponHasAmmo()) {
 		if(bFireButtonPressed && EquippedWeapon->GetAutomatic()) {
 			FireWeapon();
+			return;
 		}
 	} else {
 		//reload weapon
 		ReloadWeapon();
 	}
+
+	//no next shot, the burst is over
+	StopGunFireMontage();
 }
 
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation) {
+bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation, ECollisionChannel TraceChannel) {
 
 	//GetViewPortSize
 	FVector2D ViewPortSize{FVector2D::ZeroVector};
@@ -270,11 +361,14 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector&
 		const FVector Start{CrosshairWorldPosition};
 		const FVector End{Start + CrosshairWorldDirection * 50'000.f};
 		OutHitLocation = End;
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(this);
 		GetWorld()->LineTraceSingleByChannel(
 			OutHitResult,
 			Start,
 			End,
-			ECC_Visibility);
+			TraceChannel,
+			QueryParams);
 
 		if(OutHitResult.bBlockingHit) {
 			OutHitLocation = OutHitResult.Location;
@@ -285,11 +379,11 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector&
 	return false;
 }
 
-void AShooterCharacter::TraceForItems() {
+bool AShooterCharacter::TraceForItems() {
 	if(bShouldTraceForItems) {
     		FHitResult ItemTraceResult;
             	FVector HitLocation{FVector::ZeroVector};
-            	TraceUnderCrosshairs(ItemTraceResult, HitLocation);
+            	TraceUnderCrosshairs(ItemTraceResult, HitLocation, ECC_Interact);
             
             	if (ItemTraceResult.bBlockingHit) {
             		//for ue5 use ItemTraceResult.GetActor()
@@ -318,12 +412,7 @@ void AShooterCharacter::TraceForItems() {
             			TraceHitItem->GetPickupWidget()->SetVisibility(true);
             			TraceHitItem->EnableCustomDepth();
 
-                        if (Inventory.Num() >= INVENTORY_CAPACITY) {
-                        	//inventory is full
-							TraceHitItem->SetCharacterInventoryFull(true);	                        
-                        } else {
-                        	TraceHitItem->SetCharacterInventoryFull(false);	                        
-                        }
+                        TraceHitItem->SetCharacterInventoryFull(InventoryComponent->IsFull());
             		}
 
             		//we hit an AItem last frame
@@ -343,7 +432,10 @@ void AShooterCharacter::TraceForItems() {
 		//no longer overlapping any items
 		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
 		TraceHitItemLastFrame->DisableCustomDepth();
+		TraceHitItemLastFrame = nullptr;
 	}
+
+	return bShouldTraceForItems;
 }
 
 AWeapon* AShooterCharacter::SpawnDefaultWeapon() {
@@ -361,7 +453,7 @@ void AShooterCharacter::EquipWeapon(AWeapon* WeaponToEquip, bool bSwapping) {
 	if (WeaponToEquip) {
 
 		//get hand socket from skeletal mesh
-		const USkeletalMeshSocket* HandSocket = GetMesh()->GetSocketByName(FName("RightHandSocket"));
+		const USkeletalMeshSocket* HandSocket = RightHandSocket.GetSocket(GetMesh());
 
 		if (HandSocket) {
 			//attach weapon to the hand socket RightHandSocket
@@ -390,6 +482,12 @@ void AShooterCharacter::DropWeapon() {
 
 		EquippedWeapon->SetItemState(EItemState::EIS_Falling);
 		EquippedWeapon->ThrowWeapon();
+
+		//thrown weapons count towards the dropped item budget
+		UItemClutterSubsystem* ClutterSubsystem = GetWorld()->GetSubsystem<UItemClutterSubsystem>();
+		if (ClutterSubsystem) {
+			ClutterSubsystem->RegisterDrop(EquippedWeapon);
+		}
 	}
 }
 
@@ -411,9 +509,8 @@ void AShooterCharacter::SelectButtonReleased() {
 
 void AShooterCharacter::SwapWeapon(AWeapon* WeaponToSwap) {
 
-	if (Inventory.Num() - 1 >= EquippedWeapon->GetSlotIndex()) {
-		Inventory[EquippedWeapon->GetSlotIndex()] = WeaponToSwap;
-		WeaponToSwap->SetSlotIndex(EquippedWeapon->GetSlotIndex());
+	if (InventoryComponent->GetItem(EquippedWeapon->GetSlotIndex()) == EquippedWeapon) {
+		InventoryComponent->SetItem(EquippedWeapon->GetSlotIndex(), WeaponToSwap);
 	}
 	
 	DropWeapon();
@@ -422,10 +519,24 @@ void AShooterCharacter::SwapWeapon(AWeapon* WeaponToSwap) {
 	TraceHitItemLastFrame = nullptr;
 }
 
-void AShooterCharacter::InitializeAmmoMap() {
-	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
-	AmmoMap.Add(EAmmoType::EAT_AR, StartingARAmmo);
+void AShooterCharacter::OnInventorySlotChanged(int32 SlotIndex, AItem* Item) {
+	//slots fill from the lowest, trailing empty slots aren't part of the array
+	Inventory.Reset();
+	for (int32 i = 0; i < InventoryComponent->GetCapacity(); i++) {
+		Inventory.Add(InventoryComponent->GetItem(i));
+	}
+	while (Inventory.Num() > 0 && !Inventory.Last()) {
+		Inventory.Pop(false);
+	}
+}
+
+void AShooterCharacter::OnInventoryAmmoChanged(EAmmoType AmmoType, int32 Amount) {
+	AmmoMap.Add(AmmoType, Amount);
+}
 
+void AShooterCharacter::InitializeAmmo() {
+	InventoryComponent->SetAmmo(EAmmoType::EAT_9mm, Starting9mmAmmo);
+	InventoryComponent->SetAmmo(EAmmoType::EAT_AR, StartingARAmmo);
 }
 
 bool AShooterCharacter::WeaponHasAmmo() {
@@ -445,10 +556,8 @@ void AShooterCharacter::PlayFireSound() {
 
 void AShooterCharacter::SendBullet() {
 	//send bullet 
-	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
-	
-	if (BarrelSocket) {
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+	FTransform SocketTransform;
+	if (EquippedWeapon->GetBarrelSocketTransform(SocketTransform)) {
 
 		if (EquippedWeapon->GetMuzzleFlash()) {
 			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
@@ -469,16 +578,23 @@ void AShooterCharacter::SendBullet() {
 				AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.Actor.Get());
 				if (HitEnemy) {
 					int32 Damage{};
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone()) {
+					const bool bHeadShot{BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone()};
+					if (bHeadShot) {
 						//headshot
 						Damage = EquippedWeapon->GetHeadShotDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage, GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, true);
 					} else {
 						//body shot
 						Damage = EquippedWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage, GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, false);
+					}
+					UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage, GetController(), this, UDamageType::StaticClass());
+
+					//pooled numbers from the player's manager, the enemy's blueprint event if none is set up
+					const AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(GetController());
+					UHitNumberComponent* HitNumberComponent = PlayerController ? PlayerController->GetHitNumberComponent() : nullptr;
+					if (HitNumberComponent && HitNumberComponent->CanShowHitNumbers()) {
+						HitNumberComponent->ShowHitNumber(HitEnemy, Damage, BeamHitResult.Location, bHeadShot);
+					} else {
+						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, bHeadShot);
 					}
 				}
 			} else { //no interface, spawn default particles
@@ -496,7 +612,7 @@ void AShooterCharacter::SendBullet() {
 					
 				//"Target" particle system for beam behaviour (vector) which we take from P_SmokeTrail
 				if (Beam) {
-					Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
+					Beam->SetVectorParameter(ShooterNames::BeamTargetParam, BeamHitResult.Location);
 				}
 			}
 		}
@@ -504,16 +620,31 @@ void AShooterCharacter::SendBullet() {
 }
 
 void AShooterCharacter::PlayGunFireMontage() {
-	//play hip fire montage
+	//every shot kicks the procedural recoil in the anim instance proxy
+	ShotCount++;
+
+	//with procedural recoil the montage only starts a firing sequence, otherwise it is the recoil of every shot
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && HipFireMontage) {
+	if (AnimInstance && HipFireMontage && (!bProceduralRecoil || !AnimInstance->Montage_IsPlaying(HipFireMontage))) {
 		AnimInstance->Montage_Play(HipFireMontage);
-		AnimInstance->Montage_JumpToSection(FName("StartFire"));
+		AnimInstance->Montage_JumpToSection(ShooterNames::StartFireSection);
+	}
+}
+
+void AShooterCharacter::StopGunFireMontage() {
+	//a per shot montage ends on its own
+	if (!bProceduralRecoil || !HipFireMontage) {
+		return;
+	}
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance && AnimInstance->Montage_IsPlaying(HipFireMontage)) {
+		AnimInstance->Montage_Stop(HipFireMontage->BlendOut.GetBlendTime(), HipFireMontage);
 	}
 }
 
 void AShooterCharacter::ReloadButtonPressed() {
-	ReloadWeapon();
+	RecordCombatCommand(ECombatCommandType::ECCT_Reload);
 }
 
 void AShooterCharacter::ReloadWeapon() {
@@ -557,28 +688,9 @@ void AShooterCharacter::FinishReloading() {
 		return;
 	}
 
-	const EAmmoType AmmoType{EquippedWeapon->GetAmmoType()};
-	
-	//UpdateAmmoMap	
-	if (AmmoMap.Contains(AmmoType)) {
-		//amount of ammo of carried weapon ammo type
-		int32 CarriedAmmo = AmmoMap[AmmoType];
-
-		//space left in the magazine of equipped weapon
-		const int32 MagEmptySpace{EquippedWeapon->GetMagazineCapacity() - EquippedWeapon->GetAmmo()};
-		if (MagEmptySpace > CarriedAmmo) {
-			//reload the magazine with all the ammo we are carrying, because ammo we have is less then max ammo in magazine
-			EquippedWeapon->ReloadAmmo(CarriedAmmo);
-			CarriedAmmo = 0;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
-		} else {
-			//fill the magazine
-			EquippedWeapon->ReloadAmmo(MagEmptySpace);
-			CarriedAmmo -= MagEmptySpace;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
-		}
-	}
-	
+	//space left in the magazine of equipped weapon, filled with as much carried ammo as there is
+	const int32 MagEmptySpace{EquippedWeapon->GetMagazineCapacity() - EquippedWeapon->GetAmmo()};
+	EquippedWeapon->ReloadAmmo(InventoryComponent->TakeAmmo(EquippedWeapon->GetAmmoType(), MagEmptySpace));
 }
 
 void AShooterCharacter::FinishEquipping() {
@@ -597,13 +709,7 @@ bool AShooterCharacter::CarryingAmmo() {
 		return false;
 	}
 
-	EAmmoType AmmoType = EquippedWeapon->GetAmmoType();
-
-	if (AmmoMap.Contains(AmmoType)) {
-		return AmmoMap[AmmoType] > 0;
-	}
-
-	return false;
+	return InventoryComponent->GetAmmo(EquippedWeapon->GetAmmoType()) > 0;
 }
 
 void AShooterCharacter::GrabClip() {
@@ -612,14 +718,12 @@ void AShooterCharacter::GrabClip() {
 		return;
 	}
 
-	//index for the clip bone on the equipped weapon
-	int32 ClipBoneIndex{EquippedWeapon->GetItemMesh()->GetBoneIndex(EquippedWeapon->GetClipBoneName())};
 	//store transform of the clip
-	ClipTransform = EquippedWeapon->GetItemMesh()->GetBoneTransform(ClipBoneIndex);
+	ClipTransform = EquippedWeapon->GetClipBoneTransform();
 
 	FAttachmentTransformRules AttachmentRules(EAttachmentRule::KeepRelative, true);
 	
-	HandSceneComponent->AttachToComponent(GetMesh(), AttachmentRules, FName(TEXT("Hand_L")));
+	HandSceneComponent->AttachToComponent(GetMesh(), AttachmentRules, ShooterNames::LeftHandBone);
 	HandSceneComponent->SetWorldTransform(ClipTransform);
 
 	EquippedWeapon->SetMovingClip(true);
@@ -639,6 +743,7 @@ void AShooterCharacter::CrouchButtonPressed() {
 	}
 
 	GetCharacterMovement()->MaxWalkSpeed = bCrouching ? CrouchMovementSpeed : BaseMovementSpeed;
+	WakeTick();
 
 	if(bCrouching) {
 		GetCharacterMovement()->MaxWalkSpeed = CrouchMovementSpeed;
@@ -652,6 +757,7 @@ void AShooterCharacter::CrouchButtonPressed() {
 
 void AShooterCharacter::Jump() {
 	Super::Jump();
+	WakeTick();
 
 	if(bCrouching) {
 		bCrouching = false;
@@ -661,22 +767,33 @@ void AShooterCharacter::Jump() {
 	}
 }
 
-// Called every frame
-void AShooterCharacter::InterpCapsuleHalfHeight(float DeltaTime) {
-	float TargetCapsuleHalfHeight{bCrouching ? CrouchingCapsuleHalfHeight : StandingCapsuleHalfHeight};
+bool AShooterCharacter::InterpCapsuleHalfHeight(float DeltaTime) {
+	const float TargetCapsuleHalfHeight{bCrouching ? CrouchingCapsuleHalfHeight : StandingCapsuleHalfHeight};
+	const float CapsuleHalfHeight{GetCapsuleComponent()->GetScaledCapsuleHalfHeight()};
+	if (CapsuleHalfHeight == TargetCapsuleHalfHeight) {
+		return false;
+	}
 
-	const float InterpHalfHeight{FMath::FInterpTo(GetCapsuleComponent()->GetScaledCapsuleHalfHeight(), TargetCapsuleHalfHeight, DeltaTime, 20.f)};
+	float InterpHalfHeight{FMath::FInterpTo(CapsuleHalfHeight, TargetCapsuleHalfHeight, DeltaTime, 20.f)};
+	//snap the last bit so resizing (and updating overlaps) stops
+	if (FMath::IsNearlyEqual(InterpHalfHeight, TargetCapsuleHalfHeight, 0.1f)) {
+		InterpHalfHeight = TargetCapsuleHalfHeight;
+	}
 	//negative value if crouching; positive if standing
-	const float DeltaCapsuleHalfHeight{InterpHalfHeight - GetCapsuleComponent()->GetScaledCapsuleHalfHeight()};
+	const float DeltaCapsuleHalfHeight{InterpHalfHeight - CapsuleHalfHeight};
 	const FVector MeshOffset{0.f, 0.f, -DeltaCapsuleHalfHeight};
 	GetMesh()->AddLocalOffset(MeshOffset);
 	
 	GetCapsuleComponent()->SetCapsuleHalfHeight(InterpHalfHeight);
+	return true;
 }
 
 void AShooterCharacter::Aim() {
 	bAiming = true;
 	GetCharacterMovement()->MaxWalkSpeed = CrouchMovementSpeed;
+	//change sensitivity if aiming
+	SetLookRates();
+	WakeTick();
 }
 
 void AShooterCharacter::StopAiming() {
@@ -684,6 +801,8 @@ void AShooterCharacter::StopAiming() {
 	if (!bCrouching) {
 		GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;	
 	}
+	SetLookRates();
+	WakeTick();
 }
 
 
@@ -692,18 +811,37 @@ void AShooterCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	ChangeFOV(DeltaTime);
-	
-	//change sensitivity if aiming
-	SetLookRates();
-	
-	CalculateCrosshairSpread(DeltaTime);
+	ProcessCombatCommands();
+
+	bool bNeedsTick{false};
 
-	//Check overlapped item count then trace for items
-	TraceForItems();
+	//camera, crosshair and pickup widgets only matter to the local player
+	if (IsLocallyControlled()) {
+		bNeedsTick |= ChangeFOV(DeltaTime);
+
+		bNeedsTick |= CalculateCrosshairSpread(DeltaTime);
+
+		//Check overlapped item count then trace for items
+		bNeedsTick |= TraceForItems();
+	}
 
 	//interpolate the capsule half height based on crouching / standing
-	InterpCapsuleHalfHeight(DeltaTime);
+	bNeedsTick |= InterpCapsuleHalfHeight(DeltaTime);
+
+	if (!bNeedsTick) {
+		SetActorTickEnabled(false);
+	}
+}
+
+void AShooterCharacter::WakeTick() {
+	if (!IsActorTickEnabled()) {
+		SetActorTickEnabled(true);
+	}
+}
+
+void AShooterCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode) {
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+	WakeTick();
 }
 
 void AShooterCharacter::SetLookRates() {
@@ -716,7 +854,7 @@ void AShooterCharacter::SetLookRates() {
 	}
 }
 
-void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime) {
+bool AShooterCharacter::CalculateCrosshairSpread(float DeltaTime) {
 
 	FVector2D WalkSpeedRange{0.f, 600.f};
 	FVector2D VelocityMultiplierRange{0.f, 1.f};
@@ -752,24 +890,33 @@ void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime) {
 	}
 	
 	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor + CrosshairAimFactor + CrosshairShootingFactor;
-	
 
+	const bool bSettled{CrosshairVelocityFactor == 0.f && !GetCharacterMovement()->IsFalling() && !bFiringBullet &&
+		FMath::IsNearlyZero(CrosshairInAirFactor, 0.001f) &&
+		FMath::IsNearlyEqual(CrosshairAimFactor, bAiming ? -0.5f : 0.f, 0.001f) &&
+		FMath::IsNearlyZero(CrosshairShootingFactor, 0.001f)};
+	return !bSettled;
 }
 
 void AShooterCharacter::FinishCrosshairBulletFire() {
 	bFiringBullet = false;
+	WakeTick();
 }
 
-void AShooterCharacter::ChangeFOV(float DeltaTime) {
+bool AShooterCharacter::ChangeFOV(float DeltaTime) {
 	//set current camera field of view depending on zooming
-	if(bAiming) {
-		CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, CameraZoomedFOV, DeltaTime, ZoomInterpSpeed);
-	} else {
-		CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, CameraDefaultFOV, DeltaTime, ZoomInterpSpeed);
+	const float TargetFOV{bAiming ? CameraZoomedFOV : CameraDefaultFOV};
+	if (CameraCurrentFOV == TargetFOV) {
+		return false;
+	}
+
+	CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, TargetFOV, DeltaTime, ZoomInterpSpeed);
+	if (FMath::IsNearlyEqual(CameraCurrentFOV, TargetFOV, 0.01f)) {
+		CameraCurrentFOV = TargetFOV;
 	}
 	
 	GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
-	
+	return true;
 }
 
 
@@ -833,6 +980,7 @@ void AShooterCharacter::InitializeInterpLocations() {
 
 void AShooterCharacter::MoveForward(float Value) {
 	if (Controller && Value != 0.f) {
+		WakeTick();
 		const FRotator Rotation{Controller->GetControlRotation()};
 		const FRotator YawRotation{0, Rotation.Yaw, 0};
 
@@ -907,7 +1055,7 @@ bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation,
 	
 	//Check for crosshair trace hit
 	FHitResult CrosshairHitResult;
-	bool bCrosshairHit{TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation)};
+	bool bCrosshairHit{TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation, ECC_Weapon)};
 
 	if (bCrosshairHit) {
 		//Tentative beam location -- still need to trace from gun
@@ -920,11 +1068,14 @@ bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation,
 	const FVector WeaponTracStart{MuzzleSocketLocation};
 	const FVector StartToEnd{OutBeamLocation - MuzzleSocketLocation};
 	const FVector WeaponTraceEnd{MuzzleSocketLocation + StartToEnd * 1.25f};
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(this);
 	GetWorld()->LineTraceSingleByChannel(
 		OutHitResult,
 		WeaponTracStart,
 		WeaponTraceEnd,
-		ECC_Visibility);
+		ECC_Weapon,
+		QueryParams);
 
 	//object between barrel and beam end point
 	if (!OutHitResult.bBlockingHit) {
@@ -938,19 +1089,16 @@ bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation,
 }
 
 void AShooterCharacter::AimingButtonPressed() {
-	bAimingButtonPressed = true;
-	if(CombatState != ECombatState::ECS_Reloading && CombatState != ECombatState::ECS_Equipping && CombatState != ECombatState::ECS_Stunned) {
-		Aim();
-	}
+	RecordCombatCommand(ECombatCommandType::ECCT_AimPressed);
 }
 
 void AShooterCharacter::AimingButtonReleased() {
-	bAimingButtonPressed = false;
-	StopAiming();
+	RecordCombatCommand(ECombatCommandType::ECCT_AimReleased);
 }
 
 void AShooterCharacter::MoveRight(float Value) {
 	if (Controller && Value != 0.f) {
+		WakeTick();
 		const FRotator Rotation{Controller->GetControlRotation()};
 		const FRotator YawRotation{0, Rotation.Yaw, 0};
 
@@ -975,6 +1123,7 @@ void AShooterCharacter::IncrementOverlappedItemCount(int8 Amount) {
 		OverlappedItemCount += Amount;
 		bShouldTraceForItems = true;
 	}
+	WakeTick();
 }
 
 
@@ -995,9 +1144,7 @@ void AShooterCharacter::GetPickupItem(AItem* Item) {
 
 	AWeapon* Weapon = Cast<AWeapon>(Item);
 	if (Weapon) {
-		if (Inventory.Num() < INVENTORY_CAPACITY) {
-			Weapon->SetSlotIndex(Inventory.Num());
-			Inventory.Add(Weapon);
+		if (InventoryComponent->AddItem(Weapon) != INDEX_NONE) {
 			Weapon->SetItemState(EItemState::EIS_PickedUp);
 		} else {
 			SwapWeapon(Weapon);
@@ -1021,14 +1168,7 @@ FInterpLocation AShooterCharacter::GetInterpLocation(int32 Index) {
 
 void AShooterCharacter::PickupAmmo(AAmmo* Ammo) {
 
-	//check to see if ammo map contains ammo type
-	if(AmmoMap.Find(Ammo->GetAmmoType())) {
-		//get amount of ammo
-		int32 AmmoCount{ AmmoMap[Ammo->GetAmmoType()] };
-		AmmoCount += Ammo->GetItemCount();
-		//set the amount of ammo in the map for this type
-		AmmoMap[Ammo->GetAmmoType()] = AmmoCount;
-	}
+	InventoryComponent->AddAmmo(Ammo->GetAmmoType(), Ammo->GetItemCount());
 
 	if(EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType()) {
 		//check to see if the gun is empty
@@ -1037,65 +1177,47 @@ void AShooterCharacter::PickupAmmo(AAmmo* Ammo) {
 		}
 	}
 
-	Ammo->Destroy();
+	//pooled loot goes back to the pool, hand placed ammo is destroyed
+	ULootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<ULootSubsystem>();
+	if (LootSubsystem) {
+		LootSubsystem->ReleaseItem(Ammo);
+	} else {
+		Ammo->Destroy();
+	}
 	
 }
 
 void AShooterCharacter::FKeyPressed() {
-	if(EquippedWeapon->GetSlotIndex() == 0) {
-		return;
-	}
-
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 0);
+	RecordCombatCommand(ECombatCommandType::ECCT_EquipSlot, 0);
 }
 
 void AShooterCharacter::OneKeyPressed() {
-	if(EquippedWeapon->GetSlotIndex() == 1) {
-		return;
-	}
-
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 1);
+	RecordCombatCommand(ECombatCommandType::ECCT_EquipSlot, 1);
 }
 
 void AShooterCharacter::TwoKeyPressed() {
-	if(EquippedWeapon->GetSlotIndex() == 2) {
-		return;
-	}
-
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 2);
+	RecordCombatCommand(ECombatCommandType::ECCT_EquipSlot, 2);
 }
 void AShooterCharacter::ThreeKeyPressed() {
-	if(EquippedWeapon->GetSlotIndex() == 3) {
-		return;
-	}
-
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 3);
+	RecordCombatCommand(ECombatCommandType::ECCT_EquipSlot, 3);
 }
 void AShooterCharacter::FourKeyPressed() {
-	if(EquippedWeapon->GetSlotIndex() == 4) {
-		return;
-	}
-
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 4);
+	RecordCombatCommand(ECombatCommandType::ECCT_EquipSlot, 4);
 }
 void AShooterCharacter::FiveKeyPressed() {
-	if(EquippedWeapon->GetSlotIndex() == 5) {
-		return;
-	}
-
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 5);
+	RecordCombatCommand(ECombatCommandType::ECCT_EquipSlot, 5);
 }
 
 void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex) {
 
-	if (CurrentItemIndex != NewItemIndex && NewItemIndex < Inventory.Num() && (CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping)) {
+	AWeapon* NewWeapon = Cast<AWeapon>(InventoryComponent->GetItem(NewItemIndex));
+	if (CurrentItemIndex != NewItemIndex && NewWeapon && (CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping)) {
 
 		if(bAiming) {
 			StopAiming();
 		}
 		
 		AWeapon* OldEquippedWeapon = EquippedWeapon;
-		AWeapon* NewWeapon = Cast<AWeapon>(Inventory[NewItemIndex]);
 		EquipWeapon(NewWeapon);
 
 		OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
@@ -1105,7 +1227,7 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 		if (AnimInstance && EquipMontage) {
 			AnimInstance->Montage_Play(EquipMontage, 1.0f);
-			AnimInstance->Montage_JumpToSection(FName("Equip")); 
+			AnimInstance->Montage_JumpToSection(ShooterNames::EquipSection);
 		}
 
 		NewWeapon->PlayEquipSound(true);
@@ -1113,38 +1235,20 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 
 }
 
-int32 AShooterCharacter::GetEmptyInventorySlot() {
-	for (int32 i = 0; i < Inventory.Num(); i++) {
-		if (!Inventory[i]) {
-			return i;
-		}
-	}
-
-	if (Inventory.Num() < INVENTORY_CAPACITY) {
-		return Inventory.Num();
-	}
-
-	//inventory is full
-	return -1; 
-}
-
 void AShooterCharacter::HighlightInventorySlot() {
-	const int32 EmptySlot{GetEmptyInventorySlot()};
+	const int32 EmptySlot{InventoryComponent->GetEmptySlot()};
 	HighlightIconDelegate.Broadcast(EmptySlot, true);
 	HighlightedSlot = EmptySlot;
 }
 
 EPhysicalSurface AShooterCharacter::GetSurfaceType() {
-	FHitResult HitResult;
-	const FVector Start{GetActorLocation()};
-	const FVector End{Start + FVector(0.f, 0.f, -400.f)};
-	FCollisionQueryParams QueryParams;
-	QueryParams.bReturnPhysicalMaterial = true;
-	
-	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams);
-
-	return UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+	USurfaceQuerySubsystem* SurfaceQuery = GetWorld()->GetSubsystem<USurfaceQuerySubsystem>();
+	return SurfaceQuery ? SurfaceQuery->GetFloorSurface(this) : SurfaceType_Default;
+}
 
+bool AShooterCharacter::ShouldPlayFootstep() {
+	USurfaceQuerySubsystem* SurfaceQuery = GetWorld()->GetSubsystem<USurfaceQuerySubsystem>();
+	return !SurfaceQuery || SurfaceQuery->ShouldPlayFootstep(this);
 }
 
 void AShooterCharacter::EndStun() {
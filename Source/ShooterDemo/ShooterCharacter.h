@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "AmmoType.h"
+#include "CombatCommandBuffer.h"
+#include "MeshSocketHandle.h"
 #include "ShooterCharacter.generated.h"
 
 
@@ -52,6 +54,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	//based on controller movement
 	void TurnAtRate(float Rate);
 	void LookUpAtRate(float Rate);
@@ -66,30 +69,39 @@ protected:
 	void AimingButtonPressed();
 	void AimingButtonReleased();
 
-	void ChangeFOV(float DeltaTime);
+	//interps the camera towards the aiming / default FOV, false once it's there
+	bool ChangeFOV(float DeltaTime);
 	//set based on aiming
 	void SetLookRates();
 
-	void CalculateCrosshairSpread(float DeltaTime);
+	//false once the character stands still and the aim / fire spread has settled
+	bool CalculateCrosshairSpread(float DeltaTime);
 
 	UFUNCTION()
 	void FinishCrosshairBulletFire();
 
 	void StartCrosshairBulletFire();
 
+	//input handlers only record commands for the combat step
 	void FireButtonPressed();
 	void FireButtonReleased();
 
+	void RecordCombatCommand(ECombatCommandType Type, int32 SlotIndex = INDEX_NONE);
+
+	//runs the commands recorded since the last tick in the order they came in
+	void ProcessCombatCommands();
+	void HandleCombatCommand(const FCombatCommand& Command);
+
 	void StartFireTimer();
 
 	UFUNCTION()
 	void AutoFireReset();
 
-	//Line trace for items under the crosshair
-	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
+	//Line trace under the crosshair on the weapon or interact channel
+	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation, ECollisionChannel TraceChannel);
 
-	//Trace for items if overlapped item count is > 0
-	void TraceForItems();
+	//Trace for items if overlapped item count is > 0, false when there's nothing to trace for
+	bool TraceForItems();
 
 	//Spawns default weapon and equips it
 	class AWeapon* SpawnDefaultWeapon();
@@ -106,7 +118,8 @@ protected:
 	//drops currently equipped weapon and equips trace hit item
 	void SwapWeapon(AWeapon* WeaponToSwap);
 
-	void InitializeAmmoMap();
+	//fills the inventory with the starting ammo amounts
+	void InitializeAmmo();
 
 	//Check to make sure our weapon has ammo
 	bool WeaponHasAmmo();
@@ -115,6 +128,9 @@ protected:
 	void PlayFireSound();
 	void SendBullet();
 	void PlayGunFireMontage();
+
+	//blends out a hip fire montage left running by a burst
+	void StopGunFireMontage();
 	
 	void ReloadButtonPressed();
 
@@ -142,8 +158,11 @@ protected:
 
 	virtual void Jump() override;
 
-	//interps capsule half height when crouching / standing
-	void InterpCapsuleHalfHeight(float DeltaTime);
+	//interps capsule half height when crouching / standing, false once it's reached
+	bool InterpCapsuleHalfHeight(float DeltaTime);
+
+	//falling and landing change the crosshair spread
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
 	void Aim();
 	void StopAiming();
@@ -159,13 +178,22 @@ protected:
 
 	void ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex);
 
-	int32 GetEmptyInventorySlot();
-
 	void HighlightInventorySlot();
 
+	//keep Inventory and AmmoMap in step with the inventory component
+	UFUNCTION()
+	void OnInventorySlotChanged(int32 SlotIndex, class AItem* Item);
+	UFUNCTION()
+	void OnInventoryAmmoChanged(EAmmoType AmmoType, int32 Amount);
+
+	//surface under the character for footsteps and landings, from the surface query subsystem
 	UFUNCTION(BlueprintCallable)
 	EPhysicalSurface GetSurfaceType();
 
+	//false when footstep sound / fx of an off screen character should be skipped
+	UFUNCTION(BlueprintCallable)
+	bool ShouldPlayFootstep();
+
 	UFUNCTION(BlueprintCallable)
 	void EndStun();
 
@@ -175,9 +203,12 @@ protected:
 	void FinishDeath();
 	
 public:	
-	// Called every frame
+	// Called every frame while something is still changing; disables itself when idle
 	virtual void Tick(float DeltaTime) override;
 
+	//re-enables the tick after input or state that needs per frame updates
+	void WakeTick();
+
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -205,6 +236,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	UAnimMontage* HipFireMontage{nullptr};
 
+	//shots fired so far, the anim instance adds recoil for every new one
+	uint32 ShotCount{0};
+
+	//set once the anim blueprint applies RecoilPitch / RecoilBack; the hip fire montage then plays once per burst instead of per shot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	bool bProceduralRecoil{false};
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* ImpactParticles{nullptr};
 
@@ -320,7 +358,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
 	float CameraInterpElevation;
 
-	//Map to keep track of ammo of different ammo types
+	//carried ammo by type, a copy of the inventory component's for blueprints
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
 	TMap<EAmmoType, int32> AmmoMap;
 
@@ -385,6 +423,12 @@ private:
 	//used for knowing when the aiming button is pressed
 	bool bAimingButtonPressed;
 
+	//combat input waiting for the next tick, plus the last consumed commands
+	FCombatCommandBuffer CombatCommands;
+
+	//socket weapons are attached to, found once per character mesh
+	FMeshSocketHandle RightHandSocket;
+
 	/*==============================================================*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 	USceneComponent* WeaponInterpComp;
@@ -422,11 +466,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
 	float EquipSoundResetTime;
 
-	//array of AItems for inventory
-	UPROPERTY(VisibleAnywhere,  BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = "true"))
-	TArray<AItem*> Inventory;
+	//weapon slots and carried ammo
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = "true"))
+	class UInventoryComponent* InventoryComponent;
 
-	const int32 INVENTORY_CAPACITY{ 6 };
+	//filled inventory slots from the first, a copy of the inventory component's for blueprints
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = "true"))
+	TArray<AItem*> Inventory;
 
 	//delegate for sending slot information to inventory bar when equipping 
 	UPROPERTY(BlueprintAssignable, Category = "Delegates", meta = (AllowPrivateAccess = "true"))
@@ -481,6 +527,9 @@ public:
 	FORCEINLINE bool ShouldPlayPickupSound() const { return bShouldPlayPickupSound; }
 	FORCEINLINE bool ShouldPlayEquipSound() const { return bShouldPlayEquipSound; }
 	FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
+	FORCEINLINE UInventoryComponent* GetInventoryComponent() const { return InventoryComponent; }
+	FORCEINLINE const FCombatCommandBuffer& GetCombatCommands() const { return CombatCommands; }
+	FORCEINLINE uint32 GetShotCount() const { return ShotCount; }
 	FORCEINLINE USoundCue* GetMeleeImpactSound() const { return MeleeImpactSound; }
 	FORCEINLINE UParticleSystem* GetBloodParticles() const { return BloodParticles; }
 	FORCEINLINE float GetStunChance() const { return StunChance; }
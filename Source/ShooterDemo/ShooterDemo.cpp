@@ -3,4 +3,6 @@
 #include "ShooterDemo.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogShooterDemo);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ShooterDemo, "ShooterDemo" );
@@ -3,9 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogShooterDemo, Log, All);
+DECLARE_STATS_GROUP(TEXT("ShooterDemo"), STATGROUP_ShooterDemo, STATCAT_Advanced);
 
 #define EPS_METAL EPhysicalSurface::SurfaceType1
 #define EPS_STONE EPhysicalSurface::SurfaceType2
 #define EPS_TILE EPhysicalSurface::SurfaceType3
 #define EPS_GRASS EPhysicalSurface::SurfaceType4
-#define EPS_WATER EPhysicalSurface::SurfaceType5
\ No newline at end of file
+#define EPS_WATER EPhysicalSurface::SurfaceType5
+
+//trace channels and object types from DefaultEngine.ini
+#define ECC_Weapon ECollisionChannel::ECC_GameTraceChannel1
+#define ECC_Interact ECollisionChannel::ECC_GameTraceChannel2
+#define ECC_Item ECollisionChannel::ECC_GameTraceChannel3
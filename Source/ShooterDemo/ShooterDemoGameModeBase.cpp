@@ -3,3 +3,192 @@
 
 #include "ShooterDemoGameModeBase.h"
 
+#include "Enemy.h"
+#include "EnemyCorpseSubsystem.h"
+#include "ShooterDemo.h"
+#include "AnimationSharingManager.h"
+#include "AnimationSharingSetup.h"
+#include "Components/CapsuleComponent.h"
+#include "Kismet/GameplayStatics.h"
+
+AShooterDemoGameModeBase::AShooterDemoGameModeBase() :
+	SpawnPointTag(TEXT("EnemySpawn")),
+	bLoopWaves(false),
+	AnimationSharingSetup(nullptr),
+	NextSpawnPoint(0),
+	CurrentWave(INDEX_NONE),
+	EnemiesToSpawn(0),
+	SpawnTimer(0.f)
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void AShooterDemoGameModeBase::BeginPlay() {
+	Super::BeginPlay();
+
+	UGameplayStatics::GetAllActorsWithTag(this, SpawnPointTag, SpawnPoints);
+	if (Waves.Num() > 0 && SpawnPoints.Num() == 0) {
+		UE_LOG(LogShooterDemo, Warning, TEXT("Enemy waves are set up but no actor is tagged %s"), *SpawnPointTag.ToString());
+	}
+
+	//enemies ask for shared poses once the significance subsystem ranks them
+	if (AnimationSharingSetup) {
+		UAnimationSharingManager::CreateAnimationSharingManager(this, AnimationSharingSetup);
+	}
+
+	WarmUpPools();
+
+	if (Waves.Num() > 0) {
+		SpawnTimer = Waves[0].StartDelay;
+	}
+}
+
+void AShooterDemoGameModeBase::WarmUpPools() {
+	//the largest wave of a class decides how many of it are needed at once
+	TMap<TSubclassOf<AEnemy>, int32> PoolSizes;
+	for (const FEnemyWave& Wave : Waves) {
+		if (Wave.EnemyClass) {
+			int32& PoolSize = PoolSizes.FindOrAdd(Wave.EnemyClass);
+			PoolSize = FMath::Max(PoolSize, Wave.EnemyCount);
+		}
+	}
+
+	for (const auto& PoolPair : PoolSizes) {
+		FEnemyPool& Pool = EnemyPools.FindOrAdd(PoolPair.Key);
+		for (int32 i = Pool.Enemies.Num(); i < PoolPair.Value; i++) {
+			AEnemy* Enemy = SpawnPooledEnemy(PoolPair.Key);
+			if (Enemy) {
+				Pool.Enemies.Add(Enemy);
+			}
+		}
+	}
+}
+
+AEnemy* AShooterDemoGameModeBase::SpawnPooledEnemy(TSubclassOf<AEnemy> EnemyClass) {
+	const FTransform SpawnTransform{SpawnPoints.Num() > 0 ? SpawnPoints[0]->GetActorTransform() : FTransform::Identity};
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AEnemy* Enemy = GetWorld()->SpawnActor<AEnemy>(EnemyClass, SpawnTransform, SpawnParameters);
+	if (!Enemy) {
+		return nullptr;
+	}
+
+	Enemy->SetPooled(true);
+	//controller, blackboard and behaviour tree are created now, not when the wave starts
+	if (!Enemy->GetController()) {
+		Enemy->SpawnDefaultController();
+	}
+	Enemy->DeactivateToPool();
+	return Enemy;
+}
+
+bool AShooterDemoGameModeBase::SpawnWaveEnemy(const FEnemyWave& Wave) {
+	if (!Wave.EnemyClass || SpawnPoints.Num() == 0) {
+		return false;
+	}
+
+	FEnemyPool& Pool = EnemyPools.FindOrAdd(Wave.EnemyClass);
+	AEnemy* Enemy{nullptr};
+	while (!Enemy && Pool.Enemies.Num() > 0) {
+		Enemy = Pool.Enemies.Pop(false);
+	}
+	//an old corpse of the class goes back to the pool before its death timer
+	UEnemyCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UEnemyCorpseSubsystem>();
+	if (!Enemy && CorpseSubsystem && CorpseSubsystem->RecycleOldestCorpse(Wave.EnemyClass) && Pool.Enemies.Num() > 0) {
+		Enemy = Pool.Enemies.Pop(false);
+	}
+	if (!Enemy) {
+		//enemies of this class still alive; grow the pool rather than stall the wave
+		UE_LOG(LogShooterDemo, Warning, TEXT("Enemy pool for %s is empty, spawning at runtime"), *Wave.EnemyClass->GetName());
+		Enemy = SpawnPooledEnemy(Wave.EnemyClass);
+		if (!Enemy) {
+			return false;
+		}
+	}
+
+	const AActor* SpawnPoint = SpawnPoints[NextSpawnPoint];
+	NextSpawnPoint = (NextSpawnPoint + 1) % SpawnPoints.Num();
+
+	//spawn points sit on the floor, the capsule is centred
+	FTransform SpawnTransform{SpawnPoint->GetActorRotation(), SpawnPoint->GetActorLocation()};
+	SpawnTransform.AddToTranslation(FVector(0.f, 0.f, Enemy->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+
+	Enemy->ActivateFromPool(SpawnTransform);
+	ActiveEnemies.Add(Enemy);
+	return true;
+}
+
+void AShooterDemoGameModeBase::ReleaseEnemy(AEnemy* Enemy) {
+	if (!Enemy || ActiveEnemies.RemoveSwap(Enemy) == 0) {
+		return;
+	}
+
+	Enemy->DeactivateToPool();
+	EnemyPools.FindOrAdd(Enemy->GetClass()).Enemies.Add(Enemy);
+}
+
+bool AShooterDemoGameModeBase::IsWaveCleared() const {
+	if (EnemiesToSpawn > 0) {
+		return false;
+	}
+	for (const AEnemy* Enemy : ActiveEnemies) {
+		if (Enemy && !Enemy->IsDying()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void AShooterDemoGameModeBase::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	if (Waves.Num() == 0 || SpawnPoints.Num() == 0) {
+		return;
+	}
+
+	if (EnemiesToSpawn > 0) {
+		SpawnTimer -= DeltaSeconds;
+		if (SpawnTimer > 0.f) {
+			return;
+		}
+
+		const FEnemyWave& Wave = Waves[CurrentWave];
+		SpawnTimer = Wave.SpawnInterval;
+		//a wave that can't spawn (no class set) is skipped instead of blocking the rest
+		if (!SpawnWaveEnemy(Wave)) {
+			EnemiesToSpawn = 0;
+		} else {
+			EnemiesToSpawn--;
+		}
+
+		if (EnemiesToSpawn == 0) {
+			const int32 NextWave{CurrentWave + 1};
+			SpawnTimer = Waves.IsValidIndex(NextWave) ? Waves[NextWave].StartDelay : Waves[0].StartDelay;
+		}
+		return;
+	}
+
+	if (!IsWaveCleared()) {
+		return;
+	}
+
+	int32 NextWave{CurrentWave + 1};
+	if (!Waves.IsValidIndex(NextWave)) {
+		if (!bLoopWaves) {
+			return;
+		}
+		NextWave = 0;
+	}
+
+	SpawnTimer -= DeltaSeconds;
+	if (SpawnTimer > 0.f) {
+		return;
+	}
+
+	CurrentWave = NextWave;
+	EnemiesToSpawn = Waves[CurrentWave].EnemyCount;
+	SpawnTimer = 0.f;
+	UE_LOG(LogShooterDemo, Log, TEXT("Starting enemy wave %d (%d enemies)"), CurrentWave + 1, EnemiesToSpawn);
+}
@@ -6,12 +6,101 @@
 #include "GameFramework/GameModeBase.h"
 #include "ShooterDemoGameModeBase.generated.h"
 
+class AEnemy;
+
+USTRUCT(BlueprintType)
+struct FEnemyWave {
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<AEnemy> EnemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 EnemyCount{5};
+
+	//seconds between two enemies of the wave
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float SpawnInterval{1.f};
+
+	//seconds after the previous wave is cleared before this one starts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float StartDelay{5.f};
+};
+
+//enemies of one class waiting to be activated
+USTRUCT()
+struct FEnemyPool {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+};
+
 /**
- * 
+ * Runs enemy waves from pre-spawned pools; enemies and their controllers are created
+ * while the level loads and recycled on death instead of being destroyed
  */
 UCLASS()
 class SHOOTERDEMO_API AShooterDemoGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	AShooterDemoGameModeBase();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	//puts a dead enemy back into its pool
+	void ReleaseEnemy(AEnemy* Enemy);
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	//spawns enemies and controllers for the largest wave of each class
+	void WarmUpPools();
+
+	//spawns an inactive enemy with its controller into the pool
+	AEnemy* SpawnPooledEnemy(TSubclassOf<AEnemy> EnemyClass);
+
+	//takes an enemy from the pool and places it at the next spawn point
+	bool SpawnWaveEnemy(const FEnemyWave& Wave);
+
+	//true once every enemy of the current wave is spawned and dead
+	bool IsWaveCleared() const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Waves", meta = (AllowPrivateAccess = "true"))
+	TArray<FEnemyWave> Waves;
+
+	//actors (usually target points) with this tag are used as spawn points
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Waves", meta = (AllowPrivateAccess = "true"))
+	FName SpawnPointTag;
+
+	//start again from the first wave after the last one is cleared
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Waves", meta = (AllowPrivateAccess = "true"))
+	bool bLoopWaves;
+
+	//locomotion states shared by distant enemies, see UGruxAnimationSharingStateProcessor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation", meta = (AllowPrivateAccess = "true"))
+	class UAnimationSharingSetup* AnimationSharingSetup;
+
+	UPROPERTY()
+	TMap<TSubclassOf<AEnemy>, FEnemyPool> EnemyPools;
+
+	//enemies taken from the pools that haven't been released yet
+	UPROPERTY()
+	TArray<AEnemy*> ActiveEnemies;
+
+	UPROPERTY()
+	TArray<AActor*> SpawnPoints;
+
+	int32 NextSpawnPoint;
+
+	int32 CurrentWave;
+
+	//enemies of the current wave still to spawn
+	int32 EnemiesToSpawn;
+
+	//counts down to the next spawn or the start of the next wave
+	float SpawnTimer;
 };
@@ -0,0 +1,25 @@
+// Andrei Nikitin 2022
+
+
+#include "ShooterNames.h"
+
+namespace ShooterNames {
+	const FName StartFireSection(TEXT("StartFire"));
+	const FName EquipSection(TEXT("Equip"));
+	const FName HitReactFrontSection(TEXT("HitReactFront"));
+
+	const FName RightHandSocket(TEXT("RightHandSocket"));
+	const FName BarrelSocket(TEXT("BarrelSocket"));
+	const FName LeftHandBone(TEXT("Hand_L"));
+
+	const FName TurningCurve(TEXT("Turning"));
+	const FName RotationCurve(TEXT("CurveRotation"));
+
+	const FName BeamTargetParam(TEXT("Target"));
+	//spelled this way in the item materials
+	const FName FresnelColourParam(TEXT("FersnelColour"));
+	const FName GlowBlendAlphaParam(TEXT("GlowBlendAlpha"));
+	const FName GlowAmountParam(TEXT("GlowAmount"));
+	const FName FresnelExponentParam(TEXT("FresnelExponent"));
+	const FName FresnelReflectFractionParam(TEXT("FresnelReflectFraction"));
+}
@@ -0,0 +1,30 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//names used every shot / frame, built once instead of hashed into the name table per call
+namespace ShooterNames {
+	//montage sections
+	extern SHOOTERDEMO_API const FName StartFireSection;
+	extern SHOOTERDEMO_API const FName EquipSection;
+	extern SHOOTERDEMO_API const FName HitReactFrontSection;
+
+	//sockets and bones
+	extern SHOOTERDEMO_API const FName RightHandSocket;
+	extern SHOOTERDEMO_API const FName BarrelSocket;
+	extern SHOOTERDEMO_API const FName LeftHandBone;
+
+	//anim curves
+	extern SHOOTERDEMO_API const FName TurningCurve;
+	extern SHOOTERDEMO_API const FName RotationCurve;
+
+	//particle and material parameters
+	extern SHOOTERDEMO_API const FName BeamTargetParam;
+	extern SHOOTERDEMO_API const FName FresnelColourParam;
+	extern SHOOTERDEMO_API const FName GlowBlendAlphaParam;
+	extern SHOOTERDEMO_API const FName GlowAmountParam;
+	extern SHOOTERDEMO_API const FName FresnelExponentParam;
+	extern SHOOTERDEMO_API const FName FresnelReflectFractionParam;
+}
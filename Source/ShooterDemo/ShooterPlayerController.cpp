@@ -3,10 +3,11 @@
 
 #include "ShooterPlayerController.h"
 
+#include "HitNumberComponent.h"
 #include "Blueprint/UserWidget.h"
 
 AShooterPlayerController::AShooterPlayerController() {
-	
+	HitNumberComponent = CreateDefaultSubobject<UHitNumberComponent>(TEXT("HitNumberComponent"));
 }
 
 void AShooterPlayerController::BeginPlay() {
@@ -6,6 +6,8 @@
 #include "GameFramework/PlayerController.h"
 #include "ShooterPlayerController.generated.h"
 
+class UHitNumberComponent;
+
 /**
  * 
  */
@@ -21,6 +23,10 @@ protected:
 	virtual void BeginPlay() override;
 	
 private:
+	//shows damage numbers for everything this player hits
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Widgets", meta = (AllowPrivateAccess = "true"))
+	UHitNumberComponent* HitNumberComponent;
+
 	//reference to the overal HUD overlay blueprint class
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Widgets", meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<UUserWidget> HUDOverlayClass;
@@ -28,4 +34,7 @@ private:
 	//variable to hold the hud overlay widget after creating it
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Widgets", meta = (AllowPrivateAccess = "true"))
 	UUserWidget* HUDOverlay;
+
+public:
+	FORCEINLINE UHitNumberComponent* GetHitNumberComponent() const { return HitNumberComponent; }
 };
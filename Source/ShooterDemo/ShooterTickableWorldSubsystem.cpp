@@ -0,0 +1,36 @@
+// Andrei Nikitin 2022
+
+
+#include "ShooterTickableWorldSubsystem.h"
+
+bool UShooterTickableWorldSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	if (!Super::ShouldCreateSubsystem(Outer)) {
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UShooterTickableWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+	bInitialized = true;
+}
+
+void UShooterTickableWorldSubsystem::Deinitialize() {
+	bInitialized = false;
+	Super::Deinitialize();
+}
+
+ETickableTickType UShooterTickableWorldSubsystem::GetTickableTickType() const {
+	//the class default object must never tick
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UShooterTickableWorldSubsystem::IsTickable() const {
+	return bInitialized;
+}
+
+UWorld* UShooterTickableWorldSubsystem::GetTickableGameObjectWorld() const {
+	return GetWorld();
+}
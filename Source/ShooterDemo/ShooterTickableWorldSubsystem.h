@@ -0,0 +1,32 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterTickableWorldSubsystem.generated.h"
+
+/**
+ * Base for game world subsystems that need to run once per frame
+ */
+UCLASS(Abstract)
+class SHOOTERDEMO_API UShooterTickableWorldSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	//only created for game and PIE worlds
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+private:
+	//true between initialize and deinitialize
+	bool bInitialized{false};
+};
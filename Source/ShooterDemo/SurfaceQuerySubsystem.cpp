@@ -0,0 +1,147 @@
+// Andrei Nikitin 2022
+
+
+#include "SurfaceQuerySubsystem.h"
+
+#include "ShooterDemo.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Surface Queries"), STAT_SurfaceQueries, STATGROUP_ShooterDemo);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Surface Traces"), STAT_SurfaceTraces, STATGROUP_ShooterDemo);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throttled Footsteps"), STAT_ThrottledFootsteps, STATGROUP_ShooterDemo);
+
+USurfaceQuerySubsystem::USurfaceQuerySubsystem() :
+	TraceCacheTime(0.5f),
+	TraceCacheDistance(100.f),
+	TraceLength(400.f),
+	RecentlyRenderedTime(0.2f),
+	OffscreenFootstepInterval(0.5f),
+	PruneInterval(10.f)
+{
+
+}
+
+bool USurfaceQuerySubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	if (!Super::ShouldCreateSubsystem(Outer)) {
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurfaceQuerySubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (PruneInterval > 0.f) {
+		InWorld.GetTimerManager().SetTimer(PruneTimer, this, &USurfaceQuerySubsystem::PruneSurfaces, PruneInterval, true);
+	}
+}
+
+void USurfaceQuerySubsystem::Deinitialize() {
+	GetWorld()->GetTimerManager().ClearTimer(PruneTimer);
+	CharacterSurfaces.Empty();
+	ComponentSurfaces.Empty();
+	Super::Deinitialize();
+}
+
+void USurfaceQuerySubsystem::PruneSurfaces() {
+	const float StaleTime{GetWorld()->GetTimeSeconds() - PruneInterval};
+	for (auto It = CharacterSurfaces.CreateIterator(); It; ++It) {
+		if (!It.Key().IsValid() || It.Value().LastQueryTime < StaleTime) {
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = ComponentSurfaces.CreateIterator(); It; ++It) {
+		if (!It.Key().IsValid()) {
+			It.RemoveCurrent();
+		}
+	}
+}
+
+EPhysicalSurface USurfaceQuerySubsystem::GetHitSurface(const FHitResult& Hit) {
+	if (Hit.PhysMaterial.IsValid()) {
+		return UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get());
+	}
+
+	const UPrimitiveComponent* Component = Hit.GetComponent();
+	if (!Component) {
+		return SurfaceType_Default;
+	}
+
+	const EPhysicalSurface* CachedSurface = ComponentSurfaces.Find(Component);
+	if (CachedSurface) {
+		return *CachedSurface;
+	}
+
+	//what a simple collision trace against the component returns
+	const FBodyInstance* BodyInstance = Component->GetBodyInstance();
+	const EPhysicalSurface Surface{UPhysicalMaterial::DetermineSurfaceType(BodyInstance ? BodyInstance->GetSimplePhysicalMaterial() : nullptr)};
+	ComponentSurfaces.Add(Component, Surface);
+	return Surface;
+}
+
+EPhysicalSurface USurfaceQuerySubsystem::GetFloorSurface(const ACharacter* Character) {
+	if (!Character) {
+		return SurfaceType_Default;
+	}
+	INC_DWORD_STAT(STAT_SurfaceQueries);
+
+	//the movement component swept for the floor this frame already
+	const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+	if (Movement && Movement->IsMovingOnGround() && Movement->CurrentFloor.bBlockingHit) {
+		const EPhysicalSurface Surface{GetHitSurface(Movement->CurrentFloor.HitResult)};
+		if (Surface != SurfaceType_Default) {
+			return Surface;
+		}
+	}
+
+	FCharacterSurface& CharacterSurface = CharacterSurfaces.FindOrAdd(Character);
+	const float Time{GetWorld()->GetTimeSeconds()};
+	CharacterSurface.LastQueryTime = Time;
+	const FVector Location{Character->GetActorLocation()};
+	if (CharacterSurface.TraceTime < 0.f || Time - CharacterSurface.TraceTime > TraceCacheTime ||
+		FVector::DistSquared(CharacterSurface.TraceLocation, Location) > FMath::Square(TraceCacheDistance)) {
+		CharacterSurface.TracedSurface = TraceFloorSurface(Character);
+		CharacterSurface.TraceLocation = Location;
+		CharacterSurface.TraceTime = Time;
+	}
+	return CharacterSurface.TracedSurface;
+}
+
+EPhysicalSurface USurfaceQuerySubsystem::TraceFloorSurface(const ACharacter* Character) const {
+	INC_DWORD_STAT(STAT_SurfaceTraces);
+
+	FHitResult HitResult;
+	const FVector Start{Character->GetActorLocation()};
+	const FVector End{Start + FVector(0.f, 0.f, -TraceLength)};
+	FCollisionQueryParams QueryParams;
+	QueryParams.bReturnPhysicalMaterial = true;
+	QueryParams.AddIgnoredActor(Character);
+
+	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams);
+
+	return UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+}
+
+bool USurfaceQuerySubsystem::ShouldPlayFootstep(const ACharacter* Character) {
+	if (!Character) {
+		return false;
+	}
+
+	const float Time{GetWorld()->GetTimeSeconds()};
+	FCharacterSurface& CharacterSurface = CharacterSurfaces.FindOrAdd(Character);
+	CharacterSurface.LastQueryTime = Time;
+
+	const bool bOnScreen{Character->IsLocallyControlled() || Character->WasRecentlyRendered(RecentlyRenderedTime)};
+	if (!bOnScreen && CharacterSurface.LastFootstepTime >= 0.f && Time - CharacterSurface.LastFootstepTime < OffscreenFootstepInterval) {
+		INC_DWORD_STAT(STAT_ThrottledFootsteps);
+		return false;
+	}
+
+	CharacterSurface.LastFootstepTime = Time;
+	return true;
+}
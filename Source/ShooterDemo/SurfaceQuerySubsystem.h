@@ -0,0 +1,86 @@
+// Andrei Nikitin 2022
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SurfaceQuerySubsystem.generated.h"
+
+class ACharacter;
+class UPrimitiveComponent;
+
+/**
+ * Physical surfaces for footsteps, landings and impacts. The floor comes from the movement
+ * component's current floor; a trace is only made when that has no surface of its own (e.g.
+ * landscape layers) and is reused per character until it moves or the result gets old
+ */
+UCLASS(Config = Game)
+class SHOOTERDEMO_API USurfaceQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USurfaceQuerySubsystem();
+
+	//only created for game and PIE worlds
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	//surface the character stands on, or last stood on while in the air
+	EPhysicalSurface GetFloorSurface(const ACharacter* Character);
+
+	//surface of a hit from the returned physical material or the hit component's body
+	EPhysicalSurface GetHitSurface(const FHitResult& Hit);
+
+	//false for footsteps of characters off screen more often than the off screen interval
+	bool ShouldPlayFootstep(const ACharacter* Character);
+
+private:
+	struct FCharacterSurface {
+		EPhysicalSurface TracedSurface{SurfaceType_Default};
+		FVector TraceLocation{FVector::ZeroVector};
+		float TraceTime{-1.f};
+		float LastFootstepTime{-1.f};
+		//last GetFloorSurface / ShouldPlayFootstep call
+		float LastQueryTime{-1.f};
+	};
+
+	EPhysicalSurface TraceFloorSurface(const ACharacter* Character) const;
+
+	//drops destroyed characters and components, and characters not queried for a prune interval (e.g. pooled enemies)
+	void PruneSurfaces();
+
+	TMap<TWeakObjectPtr<const ACharacter>, FCharacterSurface> CharacterSurfaces;
+
+	//surface of the simple collision of a component, the same for every hit on it
+	TMap<TWeakObjectPtr<const UPrimitiveComponent>, EPhysicalSurface> ComponentSurfaces;
+
+	//seconds a traced floor surface is reused
+	UPROPERTY(Config)
+	float TraceCacheTime;
+
+	//distance a character may move before its floor is traced again
+	UPROPERTY(Config)
+	float TraceCacheDistance;
+
+	//length of the fallback trace below the character
+	UPROPERTY(Config)
+	float TraceLength;
+
+	//characters not rendered for this long count as off screen
+	UPROPERTY(Config)
+	float RecentlyRenderedTime;
+
+	//minimum seconds between footsteps of an off screen character
+	UPROPERTY(Config)
+	float OffscreenFootstepInterval;
+
+	//seconds between dropping stale cache entries
+	UPROPERTY(Config)
+	float PruneInterval;
+
+	FTimerHandle PruneTimer;
+};
@@ -3,6 +3,8 @@
 
 #include "Weapon.h"
 
+#include "ShooterNames.h"
+
 AWeapon::AWeapon() :
 	ThrowWeaponTime(0.7f),
 	bFalling(false),
@@ -17,9 +19,13 @@ AWeapon::AWeapon() :
 	bMovingSlide(false),
 	MaxSlideDisplacement(4.f),
 	MaxRecoilRotation(20.f),
-	bAutomatic(true)
+	bAutomatic(true),
+	RecoilPitchKick(60.f),
+	RecoilBackKick(40.f)
 {
 	PrimaryActorTick.bCanEverTick = true;
+
+	BarrelSocket.SetName(ShooterNames::BarrelSocket);
 }
 
 void AWeapon::Tick(float DeltaSeconds) {
@@ -39,6 +45,32 @@ void AWeapon::StartSlideTimer() {
 	GetWorldTimerManager().SetTimer(SlideTimer, this, &AWeapon::FinishMovingSlide, SlideDisplacementTime);
 }
 
+void AWeapon::SetWeaponType(EWeaponType Type) {
+	//bone to hide may change with the new mesh
+	if (!BoneToHide.IsNone()) {
+		GetItemMesh()->UnHideBoneByName(BoneToHide);
+	}
+
+	WeaponType = Type;
+	LoadWeaponData();
+
+	if (!BoneToHide.IsNone()) {
+		GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
+	}
+}
+
+bool AWeapon::GetBarrelSocketTransform(FTransform& OutTransform) {
+	return BarrelSocket.GetTransform(GetItemMesh(), OutTransform);
+}
+
+FTransform AWeapon::GetClipBoneTransform() {
+	//the clip bone name is editable and changes with the weapon data row
+	ClipBone.SetName(ClipBoneName);
+	FTransform ClipTransform;
+	ClipBone.GetTransform(GetItemMesh(), ClipTransform);
+	return ClipTransform;
+}
+
 bool AWeapon::ClipIsFull() {
 	return Ammo >= MagazineCapacity;
 }
@@ -86,6 +118,10 @@ void AWeapon::StopFalling() {
 void AWeapon::OnConstruction(const FTransform& Transform) {
 	Super::OnConstruction(Transform);
 
+	LoadWeaponData();
+}
+
+void AWeapon::LoadWeaponData() {
 	const FString WeaponTablePath{ TEXT("DataTable'/Game/_Game/DataTable/WeaponDataTable.WeaponDataTable'") };
 
 	UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
@@ -153,7 +189,7 @@ void AWeapon::OnConstruction(const FTransform& Transform) {
 
 		if (GetMaterialInstance()) {
 			SetDynamicMaterialInstance(UMaterialInstanceDynamic::Create(GetMaterialInstance(), this));
-			GetDynamicMaterialInstance()->SetVectorParameterValue(TEXT("FersnelColour"), GetGlowColour());
+			GetDynamicMaterialInstance()->SetVectorParameterValue(ShooterNames::FresnelColourParam, GetGlowColour());
 			GetItemMesh()->SetMaterial(GetMaterialIndex(), GetDynamicMaterialInstance());
 			EnableGlowMaterial();
 		}
@@ -165,7 +201,7 @@ void AWeapon::OnConstruction(const FTransform& Transform) {
 void AWeapon::BeginPlay() {
 	Super::BeginPlay();
 
-	if(BoneToHide != FName("")) {
+	if(!BoneToHide.IsNone()) {
 		GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
 	}
 }
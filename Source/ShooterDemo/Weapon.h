@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Item.h"
 #include "AmmoType.h"
+#include "MeshSocketHandle.h"
 #include "Engine/DataTable.h"
 #include "WeaponType.h"
 #include "Weapon.generated.h"
@@ -116,6 +117,9 @@ protected:
 	void FinishMovingSlide();
 
 	void UpdateSlideDisplacement();
+
+	//loads the weapon data table row for the current weapon type
+	void LoadWeaponData();
 	
 private:
 	FTimerHandle ThrowWeaponTimer;
@@ -150,6 +154,10 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	FName ClipBoneName;
 
+	//muzzle socket and clip bone found once per weapon mesh
+	FMeshSocketHandle BarrelSocket;
+	FMeshSocketHandle ClipBone;
+
 	//data table for weapon properties
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Data Table", meta = (AllowPrivateAccess = "true"))
 	UDataTable* WeaponDataTable;
@@ -231,6 +239,14 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	float HeadShotDamage;
 
+	//pitch speed (deg/s) each shot adds to the procedural recoil spring
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float RecoilPitchKick;
+
+	//backwards speed (cm/s) each shot adds to the procedural recoil spring
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float RecoilBackKick;
+
 public:
 	FORCEINLINE int32 GetAmmo() const { return Ammo; }
 	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
@@ -246,8 +262,18 @@ public:
 	FORCEINLINE bool GetAutomatic() const { return bAutomatic; }
 	FORCEINLINE float GetDamage() const { return Damage; }
 	FORCEINLINE float GetHeadShotDamage() const { return HeadShotDamage; }
+	FORCEINLINE float GetRecoilPitchKick() const { return RecoilPitchKick; }
+	FORCEINLINE float GetRecoilBackKick() const { return RecoilBackKick; }
 	
 	void StartSlideTimer();
+
+	//world transform of the muzzle socket, false when the mesh has none
+	bool GetBarrelSocketTransform(FTransform& OutTransform);
+
+	FTransform GetClipBoneTransform();
+
+	//changes weapon type at run-time (loot drops) and reloads its data table row
+	void SetWeaponType(EWeaponType Type);
 	
 	bool ClipIsFull();
 	